@@ -12,6 +12,13 @@
 #include "Player.hpp"
 #include "Tile.hpp"
 #include "GameState.hpp"
+#include "PersistentCache.hpp"
+#include "SearchArena.hpp"
+#include "TranspositionTable.hpp"
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <functional>
 
 namespace othello {
 
@@ -43,6 +50,74 @@ namespace othello {
         }
     };
 
+    /// The set of evaluation weights an AiMind is built with.
+    struct AiWeights {
+        unsigned int discWeight;
+        unsigned int mobilityWeight;
+        unsigned int stabilityWeight;
+        unsigned int cornerWeight;
+        int cornerAdjWeight;
+        int frontierWeight;
+    };
+
+    /// Limits for an iterative-deepening search (0 means "no limit" for every field).
+    struct SearchLimits {
+        /// Deepest iteration to run (it is also capped by the number of empty squares).
+        unsigned int maxDepth;
+        /// Stop once this many positions have been searched.
+        uint64_t maxNodes;
+        /// Stop once this much time has passed since the search started.
+        double maxSeconds;
+        /// Optional flag that another thread sets to stop the search early.
+        const std::atomic<bool>* stopFlag;
+    };
+
+    /// Result of one completed iteration of an iterative-deepening search.
+    struct SearchInfo {
+        /// Depth of the iteration, in plies (1 = only the AI's own move).
+        unsigned int depth;
+        /// Square index (BitBoard) of the best move, or -1 if the side to move has no legal move.
+        int bestMove;
+        /// Minimax score of the best move, from the point of view of the side to move.
+        int score;
+        /// Score of the second best move (INT_MIN if there is only one legal move).
+        int runnerUpScore;
+        /// Principal variation (BitBoard square indices), starting with bestMove.
+        std::vector<int> pv;
+        /// Positions searched so far, over all iterations.
+        uint64_t nodes;
+        /// Time spent so far, in seconds.
+        double seconds;
+    };
+
+    /// One root move of a multi-PV search.
+    struct RootMoveInfo {
+        /// Square index (BitBoard) of the move.
+        int move;
+        /// Depth the score below was searched to (0 = not searched yet).
+        unsigned int depth;
+        /// Minimax score of the move, from the point of view of the side to move.
+        int score;
+        /// False if the move was only proven to be outside the top lines (score is then an upper bound).
+        bool exact;
+        /// Principal variation (BitBoard square indices), starting with move.
+        std::vector<int> pv;
+    };
+
+    /// Progress report of a multi-PV search.
+    struct MultiPvInfo {
+        /// Depth of the iteration in progress.
+        unsigned int depth;
+        /// How many root moves the current iteration has searched so far (== numMoves once it's complete).
+        unsigned int movesSearched;
+        unsigned int numMoves;
+        /// The best lines, sorted by score. Moves the current iteration hasn't reached yet keep their previous-depth result.
+        std::vector<RootMoveInfo> lines;
+        /// Positions searched and time spent so far.
+        uint64_t nodes;
+        double seconds;
+    };
+
     class AiMind {
     private:
         // weights for each factor based on their importance
@@ -58,16 +133,45 @@ namespace othello {
         
         static RGBColor WHITE, BLACK;
         
-        /// Helper function for minimax used to create a new gamestate object and place each hypothetical piece
-        /// @param maxing Which mode minimax is currently in (maximizing or not).
-        /// @param depth The current depth of the minimax tree, where 0 is a leaf node.
-        /// @param thisMove The location of the new hypothetical move.
-        /// @param oldBoard The board as it was before placing the new hypothetical move.
-        /// @param alpha The current value for alpha (max) for minimax's alpha-beta pruning.
-        /// @param beta The current value for beta (min) for minimax's alpha-beta pruning.
-        int applyMinimaxMove_(bool maxing, unsigned int depth, std::shared_ptr<Tile>& thisMove, std::shared_ptr<Board>& oldBoard, int alpha, int beta);
+        /// Search results shared by every minimax call this AI makes (4 MB at the default size).
+        std::shared_ptr<TranspositionTable> table_;
+        static const unsigned int TABLE_SIZE_LOG2_;
+        
+        /// Optional second-level cache, probed when table_ misses.
+        std::shared_ptr<const PersistentCache> cache_;
+        
+        /// State of the search started by searchIterative (the limits apply to every minimax call until it returns).
+        const SearchLimits* limits_;
+        std::chrono::steady_clock::time_point searchStart_;
+        uint64_t nodes_;
+        bool aborted_;
+        
+        /// Counts a searched node and returns whether the current search has hit one of its limits.
+        bool searchAborted_();
+        
+        /// The minimax recursion. Move lists and principal variations live in the thread's arena, so a node
+        /// doesn't allocate anything; the PV found from this node is left in arena.ply(ply).
+        /// @param ply Distance from the root of the search (the arena slot this node uses).
+        /// @param arena The calling thread's arena.
+        int minimax_(const BitBoard& pos, bool maximizing, unsigned int depth, bool aiIsBlack, int alpha, int beta, unsigned int ply, SearchArena& arena);
+        
+        /// Scores one move of the side to move with minimax (the AI is the side to move).
+        /// @param pos The position before the move.
+        /// @param aiIsBlack Whether the AI (the side to move) plays black.
+        /// @param sq The square of the move.
+        /// @param depth The depth we want for minimax after the move.
+        /// @param pv If not null, set to the principal variation starting with this move.
+        /// @param alpha Lower end of the window (see evalMoveMinimax).
+        int evalMove_(const BitBoard& pos, bool aiIsBlack, int sq, unsigned int depth, std::vector<int>* pv, int alpha);
+        
+        /// Returns the discs on the given board in compact form, read from the tiles' owners.
+        /// @param board The board to read.
+        static BitBoard boardPosition_(std::shared_ptr<Board>& board);
         
     public:
+        /// The weights used by the command-line tools (batch annotator, etc.).
+        static const AiWeights DEFAULT_WEIGHTS;
+        
         /// Creates a new AI object.
         /// Can compute best moves for either the black or white player.
         /// @param discWeight Weight for number of discs a player controls.
@@ -78,18 +182,20 @@ namespace othello {
         /// @param frontierWeight Weight for the number of blank tiles next to a player's tiles.
         /// @param defaultTileCol The default 'green' color of the game board.
         AiMind(unsigned int discWeight, unsigned int mobilityWeight, unsigned int stabilityWeight, unsigned int cornerWeight, int cornerAdjWeight, int frontierWeight, RGBColor defaultTileCol);
+        /// @param weights All six evaluation weights.
+        AiMind(const AiWeights& weights, RGBColor defaultTileCol);
         
         
         /// MiniMax search algorithm implimentation, used as a general heuristic for measuring a player's position as a score.
-        /// @param maximizing Which mode minimax is currently in (maximizing or minimizing).
+        /// Works on the compact position only, so searching never creates boards or graphics objects.
+        /// @param pos The position to search from.
+        /// @param maximizing Which mode minimax is currently in (maximizing = the AI is to move, minimizing = its opponent is).
         /// @param depth The current depth of the minimax tree, where 0 is a leaf node.
-        /// @param aiPlayer Reference to the player object who we're computing the best move for.
-        /// @param opponent The opposing player.
-        /// @param thisBoard The current board we're computing the best next move on.
-        /// @param layout The reference to the board and gamestate.
+        /// @param aiIsBlack Whether the AI we're computing the score for plays black.
         /// @param alpha Max value kept for alpha-beta pruning.
         /// @param beta Min value for alpha-beta pruning.
-        int minimax(bool maximizing, unsigned int depth, std::shared_ptr<Player>& aiPlayer, std::shared_ptr<Player>& opponent, std::shared_ptr<Board>& thisBoard, std::shared_ptr<GameState>& layout, int alpha, int beta);
+        /// @param pv If not null, set to the sequence of moves (BitBoard square indices) minimax expects to be played from here (the principal variation).
+        int minimax(const BitBoard& pos, bool maximizing, unsigned int depth, bool aiIsBlack, int alpha, int beta, std::vector<int>* pv = nullptr);
         
         /// Computes the best move using minimax
         /// @param aiPlayer Reference to the player we're computing the best next move for.
@@ -99,11 +205,71 @@ namespace othello {
         /// @param depth The depth we want for minimax (how many tree nodes to build).
         unsigned int bestMoveMinimax(std::shared_ptr<Player>& aiPlayer, std::shared_ptr<Board>& mainGameBoard, std::shared_ptr<GameState>& mainGameState, std::vector<std::shared_ptr<Tile>>& possibleMoves, unsigned int depth);
         
+        /// Computes the minimax score of a single move for aiPlayer (with a full alpha-beta window by default, so scores of different moves can be compared).
+        /// @param aiPlayer Reference to the player making the move.
+        /// @param mainGameBoard Reference to the game board the move is made on.
+        /// @param move The tile to place the piece on.
+        /// @param depth The depth we want for minimax.
+        /// @param pv If not null, set to the principal variation (BitBoard square indices) starting with this move.
+        /// @param alpha Lower end of the window: a returned score <= alpha only means the move is no better than alpha.
+        int evalMoveMinimax(std::shared_ptr<Player>& aiPlayer, std::shared_ptr<Board>& mainGameBoard, std::shared_ptr<Tile>& move, unsigned int depth, std::vector<int>* pv = nullptr, int alpha = INT_MIN);
+        
+        /// Scores every legal move of a position given in compact form, without needing a rendered board.
+        /// @param pos The position to analyse.
+        /// @param blackToMove Whether black is the player to move (the scores are from their perspective).
+        /// @param moves Set to the legal move squares (BitBoard square indices), in the same order as the returned scores.
+        /// @param depth The depth we want for minimax.
+        std::vector<int> scoreMovesMinimax(const BitBoard& pos, bool blackToMove, std::vector<int>& moves, unsigned int depth);
+        
+        /// Iterative deepening: searches the position at depth 1, 2, 3... until a limit is hit, reporting every completed iteration.
+        /// An iteration interrupted by a limit is discarded, so the result is always from the deepest completed iteration.
+        /// @param pos The position to search.
+        /// @param blackToMove Whether black is the player to move.
+        /// @param limits When to stop searching.
+        /// @param onIteration Called after every completed iteration; returning false stops the search.
+        SearchInfo searchIterative(const BitBoard& pos, bool blackToMove, const SearchLimits& limits, const std::function<bool(const SearchInfo&)>& onIteration);
+        
+        /// Iterative deepening that ranks the root moves instead of just picking one: the best numLines moves get
+        /// exact scores and principal variations, the others are only proven to be worse.
+        /// All the root moves share this AI's transposition table, so each one reuses what the others searched.
+        /// @param pos The position to search.
+        /// @param blackToMove Whether black is the player to move.
+        /// @param numLines How many of the best moves to report (0 = all of them).
+        /// @param limits When to stop searching.
+        /// @param onUpdate Called after every root move is searched (so partial results can be shown right away)
+        ///                 and again when an iteration completes; returning false stops the search.
+        /// @return The lines of the deepest completed iteration.
+        MultiPvInfo searchMultiPv(const BitBoard& pos, bool blackToMove, unsigned int numLines, const SearchLimits& limits, const std::function<bool(const MultiPvInfo&)>& onUpdate);
+        
+        /// Attaches a second-level cache of results from previous sessions (nullptr to detach it).
+        /// Its results must come from the same evaluation, see evalFingerprint.
+        inline void setPersistentCache(const std::shared_ptr<const PersistentCache>& cache) {
+            cache_ = cache;
+        }
+        
+        /// This AI's transposition table, e.g. to snapshot it with PersistentCache::save.
+        inline const TranspositionTable& getTranspositionTable() const {
+            return *table_;
+        }
+        
+        /// Identifies this AI's evaluation (its weights), so cached scores are never mixed between different AIs.
+        uint64_t evalFingerprint() const;
+        
+        /// Number of positions searched by the last (or current) searchIterative call.
+        inline uint64_t getNodeCount() const {
+            return nodes_;
+        }
+        
         /// Called after a player places a piece on the board, this evaluates their gamestate advantage score.
         /// @param forWho The player for whom to calculate the gamestate advantage score (after they've placed a new piece).
         /// @param layout The gamestate from which to calculate the advantage score from.
         int evalGamestateScore(std::shared_ptr<Player>& forWho, std::shared_ptr<GameState>& layout);
         
+        /// Evaluates a position given in compact form: the same gamestate advantage score, computed with bit operations.
+        /// @param pos The position to evaluate.
+        /// @param forBlack Whether the score is for black (or white).
+        int evalPosition(const BitBoard& pos, bool forBlack) const;
+        
         //disabled constructors & operators
         AiMind(AiMind&& obj) = delete;        // move
         AiMind(const AiMind& obj) = delete;
@@ -0,0 +1,91 @@
+//
+//  AnimationTimeline.hpp
+//  Othello
+//
+//  Central scheduler for timed visual events (disc flips...): pending events
+//  sit in a min-heap keyed by due time, so a frame only touches the events
+//  that fire in it.
+//
+
+#ifndef AnimationTimeline_hpp
+#define AnimationTimeline_hpp
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace othello {
+
+    class AnimationTimeline {
+    public:
+        /// What to do when an event is due.
+        typedef std::function<void()> Action;
+
+    private:
+        struct Event_ {
+            /// Timeline time at which the event fires.
+            double dueTime;
+            /// Scheduling order, so events due at the same time fire in the order they were scheduled.
+            uint64_t order;
+            uint32_t sequence;
+            Action action;
+        };
+
+        /// Heap order for std::push_heap & co: the event due first ends up at the front.
+        struct FiresLater_ {
+            inline bool operator () (const Event_& a, const Event_& b) const {
+                return (a.dueTime > b.dueTime) || ((a.dueTime == b.dueTime) && (a.order > b.order));
+            }
+        };
+
+        std::vector<Event_> events_;
+        double now_;
+        uint64_t nextOrder_;
+        uint32_t nextSequence_;
+
+        /// Removes the events of a sequence (all of them if sequence is 0), and returns them in the order they're due.
+        std::vector<Event_> extract_(uint32_t sequence);
+
+    public:
+        AnimationTimeline();
+
+        //disabled constructors & operators
+        AnimationTimeline(const AnimationTimeline& obj) = delete;   // copy
+        AnimationTimeline(AnimationTimeline&& obj) = delete;        // move
+        AnimationTimeline& operator = (const AnimationTimeline& obj) = delete;    // copy operator
+        AnimationTimeline& operator = (AnimationTimeline&& obj) = delete;        // move operator
+
+        /// Starts a new group of events (e.g. all the flips of one move), which can then be cancelled or finished as a unit.
+        /// @return The id to schedule the group's events with (never 0).
+        uint32_t beginSequence();
+
+        /// Schedules an event.
+        /// @param sequence The group the event belongs to (see beginSequence).
+        /// @param delay Seconds from now until the event fires.
+        /// @param action What to do then.
+        void schedule(uint32_t sequence, float delay, const Action& action);
+
+        /// Moves the timeline forward, firing the events that become due (in due order).
+        /// @param dt Time since the last call.
+        void advance(float dt);
+
+        /// Drops the pending events of a sequence without firing them.
+        void cancel(uint32_t sequence);
+
+        /// Fires the pending events of a sequence right away (in due order), as if its animation had played out.
+        void finish(uint32_t sequence);
+
+        /// Fires every pending event right away.
+        void finishAll();
+
+        /// Whether a sequence still has events to fire.
+        bool isPending(uint32_t sequence) const;
+
+        /// Number of events waiting to fire.
+        inline size_t numPending() const {
+            return events_.size();
+        }
+    };
+}
+
+#endif /* AnimationTimeline_hpp */
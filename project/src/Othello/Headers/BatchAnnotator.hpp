@@ -0,0 +1,63 @@
+//
+//  BatchAnnotator.hpp
+//  Othello
+//
+//  Replays every game of a GameDatabase and scores each position with AiMind,
+//  spreading the games over a pool of worker threads.
+//
+
+#ifndef BatchAnnotator_hpp
+#define BatchAnnotator_hpp
+
+#include <string>
+#include "AiMind.hpp"
+#include "GameDatabase.hpp"
+
+namespace othello {
+
+    class BatchAnnotator {
+    private:
+        /// The games to annotate.
+        const GameDatabase& games_;
+        
+        /// Minimax depth used for every position.
+        const unsigned int depth_;
+        
+        /// Number of worker threads (each owns its own AiMind).
+        const unsigned int numThreads_;
+        
+        /// A move is flagged as a blunder when it scores at least this much less than the best move.
+        const int blunderThreshold_;
+        
+        /// Replays one game, scoring every position, and appends one output line per move to 'out'.
+        /// @param mind The calling worker's AI.
+        /// @param gameIndex Index of the game in the database.
+        /// @param out The text to append the game's annotations to.
+        /// @param numBlunders Incremented for every blunder found.
+        /// @return The number of positions annotated.
+        unsigned int annotateGame_(AiMind& mind, size_t gameIndex, std::string& out, unsigned int& numBlunders) const;
+        
+    public:
+        /// Creates a new annotator over a database of games.
+        /// @param games The games to annotate.
+        /// @param depth The minimax depth to search every position to.
+        /// @param numThreads How many worker threads to use (0 = one per core).
+        /// @param blunderThreshold Minimum score loss (compared to the best move) for a move to be flagged as a blunder.
+        BatchAnnotator(const GameDatabase& games, unsigned int depth, unsigned int numThreads, int blunderThreshold);
+        
+        //disabled constructors & operators
+        BatchAnnotator() = delete;
+        BatchAnnotator(const BatchAnnotator& obj) = delete;   // copy
+        BatchAnnotator(BatchAnnotator&& obj) = delete;        // move
+        BatchAnnotator& operator = (const BatchAnnotator& obj) = delete;    // copy operator
+        BatchAnnotator& operator = (BatchAnnotator&& obj) = delete;        // move operator
+        
+        /// Annotates every game and writes one tab-separated line per move to the output file, in game order.
+        /// Prints the overall throughput (positions/sec) when done.
+        /// @param outputPath The system filepath of the file to write.
+        /// @return The number of positions annotated.
+        size_t run(const char* outputPath);
+    };
+}
+
+#endif /* BatchAnnotator_hpp */
@@ -0,0 +1,53 @@
+//
+//  Benchmarks.hpp
+//  Othello
+//
+//  Command-line microbenchmarks for the engine's hot paths. These are run from
+//  main() with a --bench-* flag and never open a window.
+//
+
+#ifndef Benchmarks_hpp
+#define Benchmarks_hpp
+
+namespace othello {
+
+    /// Times BitBoard::canonical over a set of random positions and checks that all 8 symmetric
+    /// forms of each position canonicalise to the same board.
+    /// @param numPositions How many random positions to generate.
+    /// @param numRounds How many times to canonicalise the whole set.
+    /// @return 0 if every position passed the symmetry check, 1 otherwise.
+    int benchSymmetry(unsigned int numPositions, unsigned int numRounds);
+
+    /// Hosts many simultaneous games in a SessionManager, with a random mover standing in for every
+    /// human player, and reports the AI moves served per second and their latency percentiles.
+    /// @param numSessions How many games to play at the same time.
+    /// @param numWorkers Size of the search worker pool (0 = one per core).
+    /// @param nodesPerMove Node budget of every AI move.
+    /// @return 0 if every game was played to the end, 1 otherwise.
+    int benchHosting(unsigned int numSessions, unsigned int numWorkers, unsigned int nodesPerMove);
+
+    /// Runs fixed-depth minimax searches over random mid-game positions, reporting the nodes searched per
+    /// second and counting the heap allocations the searches make (there should be none: see SearchArena).
+    /// Allocations are only counted in a build with OTHELLO_COUNT_ALLOCATIONS=1.
+    /// @param numPositions How many positions to search.
+    /// @param depth The depth of every search.
+    /// @return 0 if the searches didn't allocate anything (or weren't counted), 1 otherwise.
+    int benchSearch(unsigned int numPositions, unsigned int depth);
+
+    /// Renders a 3D scene in an offscreen context (no window, no GPU needed) through the same path as the
+    /// game's display (culling, level of detail, render queue), with the camera going once around the scene,
+    /// and reports the ms/frame percentiles and a checksum of the last frame. A small SceneNode hierarchy (part
+    /// of it turning) is drawn along with the rest, and the world matrices it recomputes per frame are reported.
+    /// @param numCylinders Cylinders, on a square grid.
+    /// @param numRows, numCols Size of the (randomly perturbed, but the same every run) QuadMesh3D under them.
+    /// @param numInstances Copies of the obj shape, drawn as one InstancedMeshBatch above them.
+    /// @param numFrames How many frames to time.
+    /// @param objPath The shape of the instances.
+    /// @param expectedChecksum If not null, the checksum (hex) a previous run printed: the last frame must match it.
+    /// @return 0 if the scene rendered (and matched the checksum), 1 otherwise.
+    int benchRender(unsigned int numCylinders, unsigned int numRows, unsigned int numCols, unsigned int numInstances,
+                    unsigned int numFrames, const char* objPath, const char* expectedChecksum);
+
+}
+
+#endif /* Benchmarks_hpp */
@@ -0,0 +1,132 @@
+//
+//  BinaryMesh.h
+//  Othello
+//
+//  Binary mesh files: the arrays of a Mesh written as-is after a small
+//  header, so loading one is a memory copy rather than a parse. Used as an
+//  on-disk cache of parsed OBJ files.
+//
+
+#ifndef BINARY_MESH_H
+#define BINARY_MESH_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "Mesh.h"
+#include "MappedFile.h"
+
+namespace graphics3d
+{
+    /// File layout: this header, then (native byte order)
+    ///     numVertices x 3 floats of positions,
+    ///     numVertices x 3 floats of normals (only if hasNormals),
+    ///     numIndices triangle indices (uint32, 3 per triangle),
+    ///     numParts BinaryMeshPart records (ranges of indices if isIndexed, of vertices otherwise).
+    struct BinaryMeshHeader
+    {
+        char magic[8];
+        /// Bumped whenever the layout changes, which makes older files unusable.
+        uint32_t version;
+        uint32_t hasNormals;
+        uint32_t numVertices;
+        uint32_t numIndices;
+        uint32_t numParts;
+        /// Whether the mesh was an indexed triangle list (see Mesh::indices).
+        uint32_t isIndexed;
+        /// Whether the mesh went through MeshOptimizer (a copy made with optimization off isn't used
+        /// when it's on, and the reverse).
+        uint32_t isOptimized;
+        uint32_t reserved;
+        /// Hash & size of the file the mesh was made from, to tell when it's out of date.
+        uint64_t sourceHash;
+        uint64_t sourceSize;
+        /// Axis-aligned bounding box of the positions.
+        float boundsMin[3];
+        float boundsMax[3];
+    };
+
+    struct BinaryMeshPart
+    {
+        uint32_t mode;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    class BinaryMesh
+    {
+        private:
+        
+            std::unique_ptr<MappedFile> file_;
+            const BinaryMeshHeader* header_;
+        
+            static const char MAGIC_[8];
+            static const uint32_t VERSION_;
+        
+            /// Whether every part & index stays inside the arrays (a damaged file could otherwise send
+            /// drawing past their ends).
+            bool hasValidRanges_() const;
+        
+        public:
+        
+            /// Creates an empty view (nothing is mapped until open succeeds).
+            BinaryMesh();
+        
+            //disabled constructors & operators
+            BinaryMesh(const BinaryMesh& obj) = delete;
+            BinaryMesh& operator =(const BinaryMesh& obj) = delete;
+            BinaryMesh(BinaryMesh&& obj) = delete;
+            BinaryMesh& operator =(BinaryMesh&& obj) = delete;
+        
+            /// Maps a binary mesh file. A missing file is not an error; a file with the wrong version,
+            /// too short for what its header says, or with parts or indices out of range, is ignored.
+            /// @return Whether a usable file was mapped.
+            bool open(const std::string& path);
+        
+            inline bool isOpen() const
+            {
+                return header_ != nullptr;
+            }
+        
+            inline const BinaryMeshHeader& getHeader() const
+            {
+                return *header_;
+            }
+        
+            /// Whether the mesh was made from this exact source content, optimized or not as asked.
+            inline bool isFreshFor(uint64_t sourceHash, uint64_t sourceSize, bool isOptimized) const
+            {
+                return isOpen() && (header_->sourceHash == sourceHash) && (header_->sourceSize == sourceSize) &&
+                       ((header_->isOptimized != 0) == isOptimized);
+            }
+        
+            //  The arrays, inside the mapping (valid as long as this object is)
+            const GLfloat* positions() const;
+            /// nullptr if the mesh has no normals.
+            const GLfloat* normals() const;
+            const GLuint* indices() const;
+            const BinaryMeshPart* parts() const;
+        
+            /// Copies the arrays into a Mesh (a plain memory copy, nothing to parse).
+            Mesh toMesh() const;
+        
+            /// Writes a mesh. The file is replaced atomically, so a crash while saving never leaves
+            /// a truncated file behind.
+            /// @param sourceHash, sourceSize Identify the content the mesh was made from (see hashBytes).
+            /// @param isOptimized Whether the mesh went through MeshOptimizer.
+            /// @return Whether the file was written.
+            static bool write(const std::string& path, const Mesh& mesh, uint64_t sourceHash, uint64_t sourceSize,
+                              bool isOptimized);
+        
+            /// FNV-1a hash of some bytes, the identity of a source file.
+            static uint64_t hashBytes(const char* begin, const char* end);
+        
+            /// Where the binary copy of a source file goes: next to it.
+            inline static std::string cachePathFor(const std::string& sourcePath)
+            {
+                return sourcePath + ".meshbin";
+            }
+    };
+}
+
+#endif //    BINARY_MESH_H
@@ -0,0 +1,134 @@
+//
+//  BitBoard.hpp
+//  Othello
+//
+//  Compact 2x64-bit encoding of an Othello position, plus the bit-twiddling
+//  symmetry transforms used to canonicalise positions before hashing them.
+//
+
+#ifndef BitBoard_hpp
+#define BitBoard_hpp
+
+#include <cstdint>
+#include "commonTypes.h"
+
+namespace othello {
+
+    /// The 8 symmetries of the square board. Every position has up to 8 equivalent forms,
+    /// so caches should always be keyed on the canonical form (see BitBoard::canonical).
+    enum class Symmetry : uint8_t {
+        IDENTITY = 0,
+        FLIP_VERTICAL,          // mirror rows (top <-> bottom)
+        MIRROR_HORIZONTAL,      // mirror columns (left <-> right)
+        ROTATE_180,
+        FLIP_DIAGONAL,          // transpose along the a1-h8 diagonal
+        FLIP_ANTI_DIAGONAL,     // transpose along the h1-a8 diagonal
+        ROTATE_90,
+        ROTATE_270,
+        //
+        NB_SYMMETRIES
+    };
+
+    struct BitBoard {
+        /// One bit per square, bit index = 8 * (y-1) + (x-1) for a TilePoint {x, y}.
+        uint64_t black;
+        uint64_t white;
+
+        static const int NUM_SQUARES = 64;
+        static const int NUM_DIRECTIONS = 8;
+
+        /// Converts a board TilePoint (1-8, 1-8) to a bit index (0-63).
+        static inline int squareIndex(const TilePoint& at) {
+            return 8 * (at.y - 1) + (at.x - 1);
+        }
+
+        /// Converts a bit index (0-63) back to a board TilePoint.
+        static inline TilePoint squarePoint(int sq) {
+            return TilePoint{(sq & 7) + 1, (sq >> 3) + 1};
+        }
+
+        /// The standard starting position (two discs each in the center).
+        static BitBoard initialPosition();
+
+        inline uint64_t occupied() const {
+            return black | white;
+        }
+
+        inline uint64_t empties() const {
+            return ~(black | white);
+        }
+
+        inline bool operator == (const BitBoard& other) const {
+            return (black == other.black) && (white == other.white);
+        }
+        inline bool operator != (const BitBoard& other) const {
+            return !(*this == other);
+        }
+
+        /// Lexicographic ordering on (black, white), used to pick the canonical form.
+        inline bool operator < (const BitBoard& other) const {
+            return (black < other.black) || ((black == other.black) && (white < other.white));
+        }
+
+        /// Returns the squares where the given color can legally place a disc.
+        inline uint64_t legalMoves(bool forBlack) const {
+            return forBlack ? legalMoves(black, white) : legalMoves(white, black);
+        }
+
+        /// Places a disc for the given color on square sq and flips the flanked discs.
+        /// @return false (and leaves the board untouched) if the move doesn't flip anything.
+        bool play(int sq, bool forBlack);
+
+        /// Returns this position with the given symmetry applied to both colors.
+        BitBoard transformed(Symmetry sym) const;
+
+        /// Returns the lexicographically smallest of the 8 symmetric forms of this position.
+        /// @param used Set to the symmetry that maps this position to the returned canonical form.
+        ///             Map moves found on the canonical form back with transformSquare(sq, inverse(used)).
+        BitBoard canonical(Symmetry& used) const;
+
+        /// 64-bit hash of this exact position (not canonicalised).
+        uint64_t hash() const;
+
+        /// Hash of the canonical form, so that all 8 symmetric positions share one cache slot.
+        /// @param used Set to the symmetry that maps this position to its canonical form.
+        inline uint64_t canonicalHash(Symmetry& used) const {
+            return canonical(used).hash();
+        }
+
+        /// Returns the empty squares where the player owning 'mine' would flank at least one of 'theirs'.
+        static uint64_t legalMoves(uint64_t mine, uint64_t theirs);
+
+        /// Returns the discs of 'theirs' that get flipped when 'mine' plays on square sq.
+        static uint64_t flips(int sq, uint64_t mine, uint64_t theirs);
+
+        /// Moves every square of a set one step in the given direction (0 .. NUM_DIRECTIONS-1); squares pushed off the board are dropped.
+        static uint64_t shift(uint64_t bits, int dir);
+
+        /// The squares next to (any of) the given squares, not counting the squares themselves.
+        static uint64_t neighbors(uint64_t bits);
+
+        /// Number of discs in a bit set.
+        static int popCount(uint64_t bits);
+
+        /// Applies a symmetry to a single 64-bit square set.
+        static uint64_t transformBits(uint64_t bits, Symmetry sym);
+
+        /// Maps a square index through the given symmetry.
+        static int transformSquare(int sq, Symmetry sym);
+
+        /// Returns the symmetry that undoes the given one.
+        static Symmetry inverse(Symmetry sym);
+
+        /// The elementary bit-twiddling transforms, all the other symmetries are built from these.
+        static uint64_t flipVertical(uint64_t bits);
+        static uint64_t mirrorHorizontal(uint64_t bits);
+        static uint64_t flipDiagonal(uint64_t bits);
+        static uint64_t flipAntiDiagonal(uint64_t bits);
+
+        /// Index of the lowest set bit (bits must not be 0), used to iterate over square sets.
+        static int lowestSquare(uint64_t bits);
+    };
+}
+
+#endif /* BitBoard_hpp */
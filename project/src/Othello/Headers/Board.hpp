@@ -42,6 +42,11 @@ namespace othello
             
             /// Color of the game board.
             RGBColor DEFAULT_TILE_COLOR_;
+        
+            /// Display list holding the tiles & grid lines (0 until the first draw), rebuilt by draw() once invalidated.
+            /// The tiles never change during a game, so a frame only replays the list and draws the discs on top.
+            mutable GLuint tileLayerList_;
+            mutable bool tileLayerValid_;
             
             /// These variables are used in calculations related to resizing the window and converting between TilePoints and screen (mouse) coords.
             static float pixelToWorldRatio;
@@ -54,15 +59,27 @@ namespace othello
             /// @param nullplayerRef Reference to the 'null' player (null player controls tiles that have no pieces on them).
             Board(RGBColor tileColor, std::shared_ptr<Player>& nullplayerRef);
         
+            ~Board();
+        
             //disabled constructors & operators
             Board() = delete;
             Board(Board&& obj) = delete;        // move
             Board& operator = (const Board& obj) = delete;    // copy operator
             Board& operator = (Board&& obj) = delete;        // move operator
 
-            /// The draw function is run every frame.
+            /// The draw function is run every frame. It replays the cached tile layer (compiling it first if needed).
             void draw() const;
         
+            /// Makes the next draw() recompile the tile layer. Call it after changing the look of the tiles
+            /// (setTileColor does it, code that recolors single tiles must do it too).
+            inline void invalidateTileLayer() {
+                tileLayerValid_ = false;
+            }
+        
+            /// Changes the color of every tile (the board's theme).
+            /// @param tileColor The new color of the game board.
+            void setTileColor(RGBColor tileColor);
+        
             /// Adds a new piece to a tile, and the given player gains control of that tile.
             /// @param forWho Reference to the player who should control this piece.
             /// @param piece Reference to the new piece to place.
@@ -0,0 +1,51 @@
+//
+//  Bounds3D.h
+//  Othello
+//
+//  Bounding volumes (axis-aligned boxes & spheres) used to skip objects the
+//  camera can't see.
+//
+
+#ifndef BOUNDS_3D_H
+#define BOUNDS_3D_H
+
+#include <cstddef>
+#include "glPlatform.h"
+
+namespace graphics3d
+{
+    struct BoundingSphere
+    {
+        float center[3];
+        float radius;
+    };
+
+    /// An axis-aligned box. An empty box (the default) contains nothing, and objects with one are never culled.
+    struct Bounds3D
+    {
+        float min[3];
+        float max[3];
+        
+        /// The empty box (min > max), which grows to fit whatever is added to it.
+        static Bounds3D empty();
+        
+        /// The box around some points, 3 floats each.
+        static Bounds3D fromPoints(const GLfloat* xyz, size_t numPoints);
+        
+        inline bool isEmpty() const
+        {
+            return min[0] > max[0];
+        }
+        
+        void add(const float point[3]);
+        void add(const Bounds3D& other);
+        
+        /// The sphere through the corners of the box.
+        BoundingSphere sphere() const;
+        
+        /// The box around this one after a rigid transform (3 rows of a model matrix, see GraphicObject3D::poseToRows).
+        Bounds3D transformed(const GLfloat rows[12]) const;
+    };
+}
+
+#endif //    BOUNDS_3D_H
@@ -9,7 +9,10 @@
 #define CYLINDER_3D_H
 
 #include <memory>
+#include <vector>
 #include "GraphicObject3D.h"
+#include "MeshAssetCache.h"
+#include "LevelOfDetail.h"
 
 namespace graphics3d
 {
@@ -28,21 +31,26 @@ namespace graphics3d
             unsigned int numCirclePts_;
             unsigned int numRings_;
             bool isClosed_;
-            //    Switching back to a pointer, but I make it a 3D array
-            //    numCirclePts_ x (numRings_+1) x 3
-            GLfloat*** XYZ_;
-            //    only need to index around the ellipse
-            GLfloat** normals_;
-            GLfloat* topNormal_;
-            GLfloat* bottomNormal_;
+            //    The rings & caps, shared by every cylinder with the same dimensions
+            //    (see MeshAssetCache), so the unit cylinders cost one mesh each.
+            //    One mesh per level of detail, the finest (numCirclePts x numRings) first
+            std::vector<std::shared_ptr<const Mesh>> meshes_;
+            LevelOfDetail lod_;
             
             const static std::shared_ptr<Cylinder3D> UNIT_CYLINDER_OPEN;
             const static std::shared_ptr<Cylinder3D> UNIT_CYLINDER_CLOSED;
 
-            void initMeshAndNormals_();
+            /// Computes the vertices & normals of a cylinder: one triangle strip per ring, plus fans for the caps if it's closed.
+            static Mesh buildMesh_(float radiusX, float radiusY, float height,
+                                   unsigned int numCirclePts, unsigned int numRings, bool isClosed);
             
         public:
         
+            /// Coarser levels halve the points around and the rings, down to this many points...
+            static const unsigned int MIN_LOD_CIRCLE_PTS;
+            /// ...and up to this many levels in all (including the full one).
+            static const unsigned int MAX_LOD_LEVELS;
+        
             Cylinder3D(float radiusX, float radiusY, float height,
                         unsigned int numCirclePts, unsigned int numRings,
                         bool isClosed,
@@ -53,15 +61,13 @@ namespace graphics3d
                         bool isClosed,
                         const Pose& pose, const Motion& motion = Motion::NULL_MOTION);
 
-            ~Cylinder3D();
-            
             Cylinder3D(const Cylinder3D& obj) = delete;
             Cylinder3D& operator =(const Cylinder3D& obj) = delete;
             Cylinder3D(Cylinder3D&& obj) = delete;
             Cylinder3D& operator =(Cylinder3D&& obj) = delete;
             Cylinder3D() = delete;
 
-            void draw() const;
+            void drawShape() const;
             
             inline float getRadiusX()
             {
@@ -77,6 +83,11 @@ namespace graphics3d
                 return height_;
             }
             
+            inline const LevelOfDetail& getLevelOfDetail() const
+            {
+                return lod_;
+            }
+            
             static const std::shared_ptr<Cylinder3D> getOpenUnitCylinder()
             {
                 return UNIT_CYLINDER_OPEN;
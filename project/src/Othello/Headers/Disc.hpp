@@ -36,10 +36,6 @@ namespace othello {
             /// Scale of the disc.
             float size_;
         
-            /// Variables used to time the disc's animation color change after being flipped.
-            float switchColorAfter_, curSwitchTimer_;
-            RGBColor colorToSwitchTo_;
-        
             void initFromVectors_(std::vector<std::vector<float>>& vertices, std::vector<std::vector<int>>& faces);
             void initFromFile_(const char* filepath);
         
@@ -52,10 +48,6 @@ namespace othello {
             /// The draw function is called every frame,
             void draw() const;
         
-            /// The update function is called multiple times between every frame.
-            /// @param dt Time since the last update function ran.
-            void update(float dt);
-        
             /// Getters for the disc's coords.
             inline int getRow() const {
                 return (int)getX();
@@ -72,19 +64,14 @@ namespace othello {
                 return color_;
             }
         
-            /// Setters for the disc's color
+            /// Setters for the disc's color (a flip animation sets it through the game's AnimationTimeline).
             inline void setColor(RGBColor color) {
                 color_ = color;
             }
             inline void setColor(float red, float green, float blue) {
                 color_ = RGBColor{red, green, blue};
             }
-        
-            /// Sets the disc's color to the given one after a desired amount of seconds.
-            inline void setColorAfter(RGBColor color, float secs) {
-                colorToSwitchTo_ = color;
-                switchColorAfter_ = secs;
-            }
+
     };
 }
 
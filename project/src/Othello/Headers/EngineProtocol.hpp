@@ -0,0 +1,117 @@
+//
+//  EngineProtocol.hpp
+//  Othello
+//
+//  Line-based text protocol that runs AiMind as a headless engine process,
+//  driven by a match manager over stdin/stdout.
+//
+
+#ifndef EngineProtocol_hpp
+#define EngineProtocol_hpp
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "AiMind.hpp"
+#include "TimeManager.hpp"
+
+namespace othello {
+
+    /// Commands (one per line, replies are written one per line as well):
+    ///     newgame                                     reset to the starting position
+    ///     position startpos [moves <m1> <m2> ...]     set up the starting position, then play the moves
+    ///     position board <64 chars> <b|w> [moves ...] set up any position: squares a1..h1, a2..h2, ... as X (black), O (white) or - (empty)
+    ///     moves <m1> <m2> ...                         play moves on the current position ("pass" is allowed when forced)
+    ///     go [depth N] [movetime MS] [nodes N] [btime MS wtime MS [binc MS winc MS]] [multipv N] [infinite]
+    ///                                                 search the current position; prints "info ..." after every
+    ///                                                 completed iteration, then "bestmove <m>" ("pass" if forced, "none" once the game is over);
+    ///                                                 with btime/wtime the engine budgets the mover's clock itself;
+    ///                                                 multipv N reports the N best moves per iteration ("info ... multipv <rank> ...")
+    ///     stop                                        end the current search early (the bestmove line is still printed)
+    ///     isready                                     replies "readyok"
+    ///     quit                                        stop searching and exit
+    /// Malformed commands get an "error <reason>" reply and leave the engine state unchanged.
+    class EngineProtocol {
+    private:
+        std::istream& in_;
+        std::ostream& out_;
+
+        /// The engine is kept for the whole process, so nothing is rebuilt between games.
+        AiMind mind_;
+
+        BitBoard position_;
+        bool blackToMove_;
+
+        /// The search runs on its own thread so "stop" and "isready" can be read while it's going.
+        std::thread searchThread_;
+        std::atomic<bool> stopFlag_;
+        std::atomic<bool> searching_;
+        SearchLimits limits_;
+        /// Set when "go" was given the mover's clock, which is then budgeted by a TimeManager.
+        bool useClock_;
+        GameClock clock_;
+        /// Number of lines to report (1 = regular search, 0 = every legal move).
+        unsigned int multiPv_;
+
+        /// Snapshot of deep results kept between sessions (only used after useCacheFile).
+        std::string cachePath_;
+        std::shared_ptr<PersistentCache> cache_;
+        /// Most entries the snapshot may hold (16 bytes each).
+        static const size_t CACHE_MAX_ENTRIES_;
+
+        /// Serialises the replies of the reader thread and the search thread.
+        std::mutex outMutex_;
+
+        /// Writes one reply line and flushes it.
+        void send_(const std::string& line);
+
+        /// Handles "position ..." (the rest of the line is in args).
+        void setPosition_(std::istringstream& args);
+
+        /// Plays a list of moves on pos, reporting the first illegal one.
+        /// @return false (and leaves pos & blackToMove untouched) if any move is illegal.
+        bool playMoves_(std::istringstream& args, BitBoard& pos, bool& blackToMove);
+
+        /// Handles "go ..." (the rest of the line is in args).
+        void startSearch_(std::istringstream& args);
+
+        /// Body of the search thread.
+        void search_(BitBoard pos, bool blackToMove);
+
+        /// Body of the search thread for "go multipv N".
+        void searchMultiPv_(BitBoard pos, bool blackToMove, TimeManager* timeManager);
+
+        /// Waits for the current search (if any) to finish.
+        void joinSearch_();
+
+        /// Writes a move list as coordinates, e.g. "f5 d6 c3".
+        static std::string moveList_(const std::vector<int>& moves);
+
+    public:
+        /// Creates an engine reading commands from 'in' and writing replies to 'out'.
+        EngineProtocol(std::istream& in, std::ostream& out);
+
+        //disabled constructors & operators
+        EngineProtocol() = delete;
+        EngineProtocol(const EngineProtocol& obj) = delete;   // copy
+        EngineProtocol(EngineProtocol&& obj) = delete;        // move
+        EngineProtocol& operator = (const EngineProtocol& obj) = delete;    // copy operator
+        EngineProtocol& operator = (EngineProtocol&& obj) = delete;        // move operator
+
+        ~EngineProtocol();
+
+        /// Maps the snapshot file (if it exists yet) as the engine's second-level cache,
+        /// and has run() write an updated snapshot there when the session ends.
+        /// @param filepath The system filepath of the snapshot.
+        void useCacheFile(const char* filepath);
+
+        /// Reads and executes commands until "quit" or the end of the input.
+        /// @return The process exit code.
+        int run();
+    };
+}
+
+#endif /* EngineProtocol_hpp */
@@ -0,0 +1,64 @@
+//
+//  Frustum.h
+//  Othello
+//
+//  The camera's view volume, as 6 planes, and the culling pass that skips
+//  objects outside of it before they issue any GL call.
+//
+
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <memory>
+#include <vector>
+#include "GraphicObject3D.h"
+
+namespace graphics3d
+{
+    /// What a culling pass did, to report per frame.
+    struct CullStats
+    {
+        unsigned int drawn;
+        unsigned int culled;
+    };
+
+    class Frustum
+    {
+        private:
+        
+            /// Left, right, bottom, top, near, far: {a, b, c, d} with a*x + b*y + c*z + d >= 0 inside,
+            /// (a, b, c) of length 1.
+            float planes_[6][4];
+        
+        public:
+        
+            enum class Test
+            {
+                OUTSIDE,
+                INTERSECTS,
+                INSIDE
+            };
+        
+            /// The frustum of a projection x modelview matrix (column-major, like OpenGL's), in the frame the
+            /// modelview matrix starts from.
+            explicit Frustum(const GLfloat clip[16]);
+        
+            /// The frustum of the current GL projection & modelview matrices (so, in the current frame:
+            /// call it where objects are about to be drawn, e.g. right after cameraToWorld).
+            static Frustum fromCurrentMatrices();
+        
+            bool mayContain(const BoundingSphere& sphere) const;
+        
+            Test classify(const Bounds3D& box) const;
+        
+            /// Whether an object may be seen: sphere test first (cheap), then the box.
+            /// Objects without bounds are always kept.
+            bool mayContain(const GraphicObject3D& object) const;
+        
+            /// Appends the objects that may be seen to 'visible' and counts them in 'stats'.
+            void cull(const std::vector<std::shared_ptr<GraphicObject3D>>& objects,
+                      std::vector<GraphicObject3D*>& visible, CullStats& stats) const;
+    };
+}
+
+#endif //    FRUSTUM_H
@@ -0,0 +1,106 @@
+//
+//  GameDatabase.hpp
+//  Othello
+//
+//  Compact in-memory store of recorded games, filled by streaming WTHOR
+//  binary archives or plain move-list text files.
+//
+
+#ifndef GameDatabase_hpp
+#define GameDatabase_hpp
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BitBoard.hpp"
+
+namespace othello {
+
+    /// One recorded game: 68 bytes, the same footprint as a WTHOR record.
+    struct StoredGame {
+        /// Maximum number of moves in a game (60 empty squares at the start).
+        static const int MAX_MOVES = 60;
+        /// Padding value for unused move slots.
+        static const uint8_t NO_MOVE = 0xFF;
+
+        /// Moves as BitBoard square indices, in the order they were played (passes are implicit).
+        uint8_t moves[MAX_MOVES];
+        uint8_t numMoves;
+        /// Number of black discs at the end of the game, as recorded in the archive (0 if unknown).
+        uint8_t blackScore;
+        uint16_t tournamentId;
+        uint16_t blackPlayerId;
+        uint16_t whitePlayerId;
+    };
+
+    class GameDatabase {
+    private:
+        std::vector<StoredGame> games_;
+
+        /// Size of a WTHOR file header and of one game record, in bytes.
+        static const int WTHOR_HEADER_SIZE_;
+        static const int WTHOR_RECORD_SIZE_;
+
+        /// Number of WTHOR records read from disk per chunk.
+        static const int WTHOR_RECORDS_PER_CHUNK_;
+
+        /// Replays a game from the initial position, dropping everything from its first illegal move on.
+        /// @param game The game to check (numMoves is truncated if an illegal move is found).
+        /// @return false if the game had to be truncated.
+        static bool validate_(StoredGame& game);
+
+    public:
+        GameDatabase() = default;
+
+        //disabled constructors & operators
+        GameDatabase(const GameDatabase& obj) = delete;   // copy
+        GameDatabase(GameDatabase&& obj) = delete;        // move
+        GameDatabase& operator = (const GameDatabase& obj) = delete;    // copy operator
+        GameDatabase& operator = (GameDatabase&& obj) = delete;        // move operator
+
+        /// Imports a file, choosing the format from its extension (.wtb = WTHOR, anything else = move lists).
+        /// @param filepath The system filepath to the archive.
+        /// @return The number of games added to the store.
+        size_t importFile(const char* filepath);
+
+        /// Streams a WTHOR binary archive (16-byte header followed by 68-byte game records) into the store.
+        /// @param filepath The system filepath to the .wtb file.
+        /// @return The number of games added to the store.
+        size_t importWthor(const char* filepath);
+
+        /// Streams a text file with one game per line, written as coordinates such as "f5d6c3d3c4".
+        /// Blank lines and lines starting with '#' are skipped.
+        /// @param filepath The system filepath to the text file.
+        /// @return The number of games added to the store.
+        size_t importMoveList(const char* filepath);
+
+        /// Parses one move-list line into a game. Returns false if the line holds no moves.
+        /// @param line The text to parse, e.g. "f5 d6 c3" or "F5D6C3" ("pa" or "--" passes are skipped).
+        /// @param game The game to fill.
+        static bool parseMoveList(const std::string& line, StoredGame& game);
+
+        /// Plays a recorded move, passing for the side to move first if they have no legal move.
+        /// @param pos The position to play the move on.
+        /// @param blackToMove Whether black is to play; updated for the next move.
+        /// @param sq The square index of the move.
+        /// @return false (and leaves pos untouched) if the move is illegal for both sides.
+        static bool playMove(BitBoard& pos, bool& blackToMove, int sq);
+
+        /// Writes a square index as a coordinate such as "f5".
+        static std::string squareName(int sq);
+
+        inline size_t size() const {
+            return games_.size();
+        }
+
+        inline const StoredGame& at(size_t index) const {
+            return games_[index];
+        }
+
+        inline void clear() {
+            games_.clear();
+        }
+    };
+}
+
+#endif /* GameDatabase_hpp */
@@ -0,0 +1,119 @@
+//
+//  GameModel.hpp
+//  Othello
+//
+//  The rules-only model of a game: plain value types for sides, squares and
+//  moves, with no graphics objects. Views observe it to stay in sync.
+//
+
+#ifndef GameModel_hpp
+#define GameModel_hpp
+
+#include <cstdint>
+#include <vector>
+#include "BitBoard.hpp"
+
+namespace othello {
+
+    /// Who owns a square (or whose turn it is).
+    enum class Side : uint8_t {
+        NONE = 0,
+        BLACK,
+        WHITE
+    };
+
+    inline Side opponentOf(Side side) {
+        return (side == Side::BLACK) ? Side::WHITE : ((side == Side::WHITE) ? Side::BLACK : Side::NONE);
+    }
+
+    /// A committed move.
+    struct MoveRecord {
+        /// Square index (BitBoard) of the new disc, or -1 for a pass.
+        int square;
+        Side who;
+        /// The opponent discs this move flipped.
+        uint64_t flipped;
+    };
+
+    /// Interface for views (the rendered board, a move list...) that follow a GameModel.
+    class GameObserver {
+    public:
+        virtual ~GameObserver() = default;
+
+        /// A disc was put on the board without flipping anything (while setting a position up).
+        virtual void onDiscAdded(int square, Side who) = 0;
+
+        /// A move was played.
+        virtual void onMovePlayed(const MoveRecord& move) = 0;
+    };
+
+    class GameModel {
+    private:
+        BitBoard position_;
+        Side toMove_;
+        std::vector<MoveRecord> history_;
+
+        /// Not owned: observers must remove themselves (or outlive the model).
+        std::vector<GameObserver*> observers_;
+
+    public:
+        /// Creates an empty board with black to move (set it up with addDisc, or start from BitBoard::initialPosition).
+        GameModel();
+        /// @param position The starting position.
+        /// @param toMove The side to move first.
+        GameModel(const BitBoard& position, Side toMove);
+
+        //disabled constructors & operators
+        GameModel(const GameModel& obj) = delete;   // copy
+        GameModel(GameModel&& obj) = delete;        // move
+        GameModel& operator = (const GameModel& obj) = delete;    // copy operator
+        GameModel& operator = (GameModel&& obj) = delete;        // move operator
+
+        void addObserver(GameObserver* observer);
+        void removeObserver(GameObserver* observer);
+
+        /// Puts a disc on an empty square without flipping anything (for setting positions up).
+        /// @return false if the square is already taken.
+        bool addDisc(int square, Side who);
+
+        /// Plays a move for the given side, whether or not it's their turn, and gives the turn to the opponent.
+        /// @return false (and changes nothing) if the move doesn't flip anything.
+        bool place(Side who, int square);
+
+        /// Plays a move for the side to move.
+        inline bool play(int square) {
+            return place(toMove_, square);
+        }
+
+        /// Passes the turn.
+        /// @return false if the side to move has a legal move (passing is only allowed when forced).
+        bool pass();
+
+        /// The squares where the given side can play.
+        inline uint64_t legalMoves(Side who) const {
+            return (who == Side::NONE) ? 0 : position_.legalMoves(who == Side::BLACK);
+        }
+
+        inline bool isGameOver() const {
+            return (position_.legalMoves(true) == 0) && (position_.legalMoves(false) == 0);
+        }
+
+        Side owner(int square) const;
+
+        int discCount(Side who) const;
+
+        inline const BitBoard& getPosition() const {
+            return position_;
+        }
+
+        inline Side getSideToMove() const {
+            return toMove_;
+        }
+
+        inline const std::vector<MoveRecord>& getHistory() const {
+            return history_;
+        }
+    };
+}
+
+#endif /* GameModel_hpp */
@@ -14,10 +14,15 @@
 #include <memory>
 #include "Board.hpp"
 #include "Player.hpp"
+#include "BitBoard.hpp"
+#include "GameModel.hpp"
+#include "AnimationTimeline.hpp"
 
 
 namespace othello {
-    class GameState {
+    /// The rendered game: follows a GameModel (which holds the rules & the position) and keeps the
+    /// board's tiles and discs in sync with it. Discs are only created for moves the model commits.
+    class GameState : public GameObserver {
     private:
         /// number of players in the game
         static const int NUM_GAME_PLAYERS;
@@ -32,16 +37,31 @@ namespace othello {
         std::shared_ptr<Player> playerBlack_;
         std::shared_ptr<Player> playerWhite_;
         
+        /// The rules-only state of the game, which this GameState renders.
+        GameModel model_;
+        
+        /// Pending flip animations, one sequence per move.
+        AnimationTimeline timeline_;
+        
+        /// The disc created for the latest model update (returned by placePiece & appended by addGamePiece).
+        std::shared_ptr<Disc> lastDisc_;
+        
+        /// Maps between the players & the model's sides (by color, so any player object of the right color works).
+        Side sideOf_(std::shared_ptr<Player>& player);
+        std::shared_ptr<Player>& playerFor_(Side side);
+        
     public:
         /// Constructs a new GameState object, which stores references player objects & board object.
-        /// Creating new GameState objects other than the main one (the one that's rendered in the game window) is done when an AI needs to hypothesize different possible moves that it can take.
-        /// Each new GameState object needs a new separate board object, as the whole point of creating a new GameState object is that it contains a different board state than others,
-        /// but also needs new separate player objects as well.
+        /// The game normally has a single GameState (the one that's rendered in the game window): the AI doesn't create
+        /// GameStates to hypothesize moves, it searches on copies of the GameModel's BitBoard instead.
+        /// Any other GameState needs its own separate board object (and player objects), since its board state differs from the main one's.
         /// @param playerWhite This GameState's reference to the White player.
         /// @param playerBlack This GameState's reference to the Black player.
         /// @param board The reference to this GameState's game board.
         GameState(std::shared_ptr<Player>& playerWhite, std::shared_ptr<Player>& playerBlack, std::shared_ptr<Board>& board);
         
+        ~GameState();
+        
         //disabled constructors & operators
         GameState(const GameState& obj) = delete;   // copy
         GameState() = delete;
@@ -73,8 +93,10 @@ namespace othello {
         std::shared_ptr<Tile> computeTileClicked(float ix, float iy, std::vector<std::shared_ptr<Tile>>& movableTiles);
         
         /// Place a new piece (disc) on the given tile. Per Othello rules, also flips all opposing tiles which are flanked by the given player.
+        /// The move is played on the model, and the new disc is created when the model reports it.
         /// @param forWho Reference to the player who should own the new piece.
         /// @param on Reference to the tile to place the new piece on.
+        /// @return The new disc, or nullptr if the move is illegal (it flanks nothing).
         std::shared_ptr<Disc> placePiece(std::shared_ptr<Player>& forWho, std::shared_ptr<Tile>& on);
         /// @param returnInt If a boolean is given to placePiece as the final param, the function will return how many opposing pieces this move flipped instead of a pointer to the new Disc it placed.
         unsigned int placePiece(std::shared_ptr<Player>& forWho, std::shared_ptr<Tile>& on, bool returnInt);
@@ -106,6 +128,35 @@ namespace othello {
         /// Overloaded definition that doesn't append to allObjects
         void addGamePiece(TilePoint location, std::shared_ptr<Player>& whose);
         
+        /// Returns the compact 2x64-bit encoding of the current board (used as a key by the AI's caches).
+        inline BitBoard toBitBoard() const {
+            return model_.getPosition();
+        }
+        
+        /// The rules-only model this GameState renders.
+        inline GameModel& getModel() {
+            return model_;
+        }
+        
+        /// Plays the flip animations forward: only the flips that become due are processed, however full the board is.
+        /// @param dt Time since the last update.
+        inline void updateAnimations(float dt) {
+            timeline_.advance(dt);
+        }
+        
+        /// Shows the final colors of every move right away (e.g. to skip the animation when the AI answers instantly).
+        inline void finishAnimations() {
+            timeline_.finishAll();
+        }
+        
+        inline AnimationTimeline& getTimeline() {
+            return timeline_;
+        }
+        
+        /// GameObserver: creates the disc for a set-up disc or a played move, and animates the flips.
+        void onDiscAdded(int square, Side who);
+        void onMovePlayed(const MoveRecord& move);
+        
         /// Get a Tile on the board from its position
         /// @param at the TilePoint position of the tile to return
         inline std::shared_ptr<Tile> getBoardTile(TilePoint& at) const {
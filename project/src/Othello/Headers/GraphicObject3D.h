@@ -11,6 +11,7 @@
 #include <stdio.h>
 #include "common.h"
 #include "drawingUtilities.h"
+#include "Bounds3D.h"
 
 namespace graphics3d
 {
@@ -21,6 +22,25 @@ namespace graphics3d
             Pose pose_;
             Motion motion_;
             Material material_;
+            //    see materialId (0 until a material is set)
+            unsigned int materialId_;
+            //    Bounds in the object's own frame (empty if the subclass didn't set any),
+            //    and in its parent's frame, recomputed only after the pose changed
+            Bounds3D localBounds_;
+            mutable Bounds3D worldBounds_;
+            mutable BoundingSphere worldSphere_;
+            mutable bool worldBoundsValid_;
+            //    The pose as a matrix (column-major, for glMultMatrixf), also recomputed
+            //    only after the pose changed
+            mutable GLfloat poseMatrix_[16];
+            mutable bool poseMatrixValid_;
+            
+            void updateWorldBounds_() const;
+            
+        protected:
+        
+            /// Subclasses call this with the box around their geometry (and again if it changes).
+            void setLocalBounds(const Bounds3D& bounds);
             
         public:
         
@@ -35,13 +55,25 @@ namespace graphics3d
             GraphicObject3D& operator =(GraphicObject3D&& obj) = delete;
             GraphicObject3D() = delete;
 
-            virtual void draw() const = 0;
+            /// Draws the object where its pose puts it (in its parent's frame).
+            virtual void draw() const;
+            
+            /// Draws the object's geometry in its own frame: the pose must already be applied
+            /// (by draw, or by whoever loaded the object's matrix).
+            virtual void drawShape() const = 0;
+            
             virtual void update(float dt);
             
             void setMaterial(const Material& material);
             
             const Material& getMaterial() const;
             
+            /// Identifies the material, for sorting objects by it (0 if none was set).
+            inline unsigned int getMaterialId() const
+            {
+                return materialId_;
+            }
+            
             inline const Pose& getPose() const
             {
                 return pose_;
@@ -55,6 +87,40 @@ namespace graphics3d
             inline void setPose(const Pose& pose)
             {
                 pose_ = pose;
+                worldBoundsValid_ = false;
+                poseMatrixValid_ = false;
+            }
+            
+            /// The pose as a column-major matrix (cached, so drawing an object at rest costs no trigonometry).
+            inline const GLfloat* getPoseMatrix() const
+            {
+                if (!poseMatrixValid_)
+                {
+                    poseToMatrix(pose_, poseMatrix_);
+                    poseMatrixValid_ = true;
+                }
+                return poseMatrix_;
+            }
+            
+            inline const Bounds3D& getLocalBounds() const
+            {
+                return localBounds_;
+            }
+            
+            /// The box around the object where its pose puts it (the world, for objects drawn in the world frame).
+            /// Empty if the object has no bounds, in which case it should never be culled.
+            inline const Bounds3D& getWorldBounds() const
+            {
+                if (!worldBoundsValid_)
+                    updateWorldBounds_();
+                return worldBounds_;
+            }
+            
+            inline const BoundingSphere& getWorldSphere() const
+            {
+                if (!worldBoundsValid_)
+                    updateWorldBounds_();
+                return worldSphere_;
             }
             
             inline void setMotion(const Motion& motion)
@@ -62,12 +128,16 @@ namespace graphics3d
                 motion_ = motion;
             }
             
+            /// Whether update() moves the object (objects at rest can go in an ObjectBVH).
+            inline bool isMoving() const
+            {
+                return (motion_.vX != 0.f) || (motion_.vY != 0.f) || (motion_.vZ != 0.f) ||
+                       (motion_.spinX != 0.f) || (motion_.spinY != 0.f) || (motion_.spinZ != 0.f);
+            }
+            
             inline void applyPose() const
             {
-                glTranslatef(pose_.tX, pose_.tY, pose_.tZ);
-                glRotatef(pose_.roll, 0.f, 0.f, 1.f);
-                glRotatef(pose_.yaw, 0.f, 1.f, 0.f);
-                glRotatef(pose_.pitch, 1.f, 0.f, 0.f);
+                glMultMatrixf(getPoseMatrix());
             }
 
             inline static void applyPose(const Pose& pose)
@@ -78,6 +148,15 @@ namespace graphics3d
                 glRotatef(pose.pitch, 1.f, 0.f, 0.f);
             }
 
+            /// Writes the 3 rows of the model matrix of a pose (same transform as applyPose) into rows[12].
+            static void poseToRows(const Pose& pose, GLfloat rows[12]);
+            
+            /// Same, as a full column-major 4x4 matrix (what glMultMatrixf & glLoadMatrixf take).
+            static void poseToMatrix(const Pose& pose, GLfloat matrix[16]);
+            
+            /// The pose of a rigid column-major matrix (the reverse of poseToMatrix).
+            static Pose matrixToPose(const GLfloat matrix[16]);
+
     };
 
 
@@ -0,0 +1,102 @@
+//
+//  InstancedMeshBatch.h
+//  Othello
+//
+//  Many copies of one mesh (e.g. the 64 discs of the board), each with its own
+//  pose and colour, drawn with a single instanced call where the context
+//  supports it and from a display list where it doesn't.
+//
+
+#ifndef INSTANCED_MESH_BATCH_H
+#define INSTANCED_MESH_BATCH_H
+
+#include <memory>
+#include <vector>
+#include "GraphicObject3D.h"
+#include "Mesh.h"
+
+namespace graphics3d
+{
+    /// One copy of the batch's mesh, relative to the batch's own pose.
+    struct MeshInstance
+    {
+        Pose pose;
+        /// Ambient & diffuse colour (RGBA).
+        GLfloat color[4];
+    };
+
+    class InstancedMeshBatch : public GraphicObject3D
+    {
+        private:
+        
+            std::shared_ptr<const Mesh> mesh_;
+            std::vector<MeshInstance> instances_;
+            bool useInstancing_;
+        
+            /// The mesh as plain triangles (position & normal, 6 floats per vertex) in a vertex buffer,
+            /// uploaded on the first instanced draw (0 until then).
+            mutable GLuint triangleBuffer_;
+            mutable GLsizei numTriangleVertices_;
+            /// Per-instance attributes: 3 rows of the model matrix then the colour (16 floats per instance),
+            /// staged here and re-uploaded to their buffer only after an instance changed.
+            mutable std::vector<GLfloat> instanceData_;
+            mutable GLuint instanceBuffer_;
+            mutable bool instanceDataValid_;
+            /// The mesh compiled for the fallback path (0 until the first fallback draw).
+            mutable GLuint displayList_;
+            /// The box around the mesh, in the mesh's own frame.
+            Bounds3D meshBounds_;
+        
+            void drawInstanced_() const;
+            void drawFallback_() const;
+            void uploadTriangles_() const;
+            void uploadInstanceData_() const;
+        
+            /// The shader of the instanced path, shared by all batches (0 if it couldn't be built).
+            static GLuint program_();
+        
+        public:
+        
+            /// @param mesh The shape every instance is drawn with.
+            /// @param pose Placement of the whole batch (instance poses are relative to it).
+            InstancedMeshBatch(std::shared_ptr<const Mesh> mesh, const Pose& pose, const Motion& motion = Motion::NULL_MOTION);
+            ~InstancedMeshBatch();
+        
+            //disabled constructors & operators
+            InstancedMeshBatch(const InstancedMeshBatch& obj) = delete;
+            InstancedMeshBatch& operator =(const InstancedMeshBatch& obj) = delete;
+            InstancedMeshBatch(InstancedMeshBatch&& obj) = delete;
+            InstancedMeshBatch& operator =(InstancedMeshBatch&& obj) = delete;
+            InstancedMeshBatch() = delete;
+        
+            /// @return the index of the new instance.
+            unsigned int add(const Pose& pose, const GLfloat color[4]);
+            void setInstancePose(unsigned int index, const Pose& pose);
+            void setInstanceColor(unsigned int index, const GLfloat color[4]);
+            void clear();
+        
+            inline unsigned int size() const
+            {
+                return (unsigned int) instances_.size();
+            }
+        
+            inline const MeshInstance& getInstance(unsigned int index) const
+            {
+                return instances_[index];
+            }
+        
+            /// Forces the display-list path even where instancing is available (to compare the two).
+            inline void setUseInstancing(bool useInstancing)
+            {
+                useInstancing_ = useInstancing;
+            }
+        
+            /// Draws every instance: one draw call with instancing, one glCallList per instance without.
+            void drawShape() const;
+        
+            /// Whether the current context can take the instanced path (needs a current context).
+            static bool instancingAvailable();
+    };
+}
+
+#endif //    INSTANCED_MESH_BATCH_H
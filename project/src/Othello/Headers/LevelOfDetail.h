@@ -0,0 +1,100 @@
+//
+//  LevelOfDetail.h
+//  Othello
+//
+//  Picks one of several tessellations of an object, frame by frame, from how
+//  big the object is on screen, so that far-away primitives cost less.
+//
+
+#ifndef LEVEL_OF_DETAIL_H
+#define LEVEL_OF_DETAIL_H
+
+#include <vector>
+#include "Bounds3D.h"
+#include "glPlatform.h"
+
+namespace graphics3d
+{
+    /// Triangles of the objects drawn since LevelOfDetail::beginFrame: what they would cost at their
+    /// finest level, and what they cost at the level picked.
+    struct LodStats
+    {
+        unsigned long trianglesFull;
+        unsigned long trianglesDrawn;
+    };
+
+    class LevelOfDetail
+    {
+        private:
+        
+            /// Level 0 is the finest. Largest size on screen (pixels) at which each level still looks fine.
+            std::vector<float> maxPixels_;
+            std::vector<unsigned int> numTriangles_;
+            /// The level picked last time (remembered for the hysteresis).
+            mutable unsigned int current_;
+        
+            /// Projection's vertical scale x half the viewport's height (0 until beginFrame is called).
+            static float pixelScale_;
+            /// The modelview matrix when beginFrame was called: the camera's view of the world.
+            static GLfloat view_[16];
+            static bool isPerspective_;
+            static bool enabled_;
+            static LodStats frameStats_;
+        
+        public:
+        
+            /// Target size on screen of one tessellation step.
+            static const float EDGE_PIXELS;
+            /// Fraction below a level's limit an object must shrink to before switching to it, so that
+            /// an object hovering around a limit doesn't pop back and forth.
+            static const float HYSTERESIS;
+        
+            /// Creates an object with no level yet (select always gives 0).
+            LevelOfDetail();
+        
+            /// Adds the next coarser level (levels go from the finest to the coarsest).
+            /// @param stepsAcross How many tessellation steps the level has across the object.
+            /// @param numTriangles The level's triangles, for the stats.
+            void addLevel(float stepsAcross, unsigned int numTriangles);
+        
+            inline unsigned int numLevels() const
+            {
+                return (unsigned int) maxPixels_.size();
+            }
+        
+            inline unsigned int numTriangles(unsigned int level) const
+            {
+                return numTriangles_[level];
+            }
+        
+            /// Picks the level to draw, from the size on screen of 'worldSphere' (the object's cached
+            /// GraphicObject3D::getWorldSphere), and counts it in the frame's stats.
+            unsigned int select(const BoundingSphere& worldSphere) const;
+        
+            /// Reads the view (the current modelview matrix, so call it once the camera is set), projection
+            /// & viewport for this frame and clears the stats. Call it once per frame before drawing;
+            /// until it's called, select always gives the finest level.
+            static void beginFrame();
+        
+            /// Diameter in pixels of a sphere given in the world frame, seen through the view beginFrame read.
+            static float screenSize(const BoundingSphere& worldSphere);
+        
+            static inline const LodStats& frameStats()
+            {
+                return frameStats_;
+            }
+        
+            static inline bool isEnabled()
+            {
+                return enabled_;
+            }
+        
+            /// Disabled, objects always draw their finest level (the stats still count them).
+            static inline void setEnabled(bool enabled)
+            {
+                enabled_ = enabled;
+            }
+    };
+}
+
+#endif //    LEVEL_OF_DETAIL_H
@@ -0,0 +1,64 @@
+//
+//  MappedFile.h
+//  Othello
+//
+//  Read-only view of a whole file. Memory-mapped where the platform allows
+//  it, so large assets are parsed straight from the page cache.
+//
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace graphics3d
+{
+    class MappedFile
+    {
+        private:
+        
+            const char* data_;
+            size_t size_;
+            /// Whether data_ is a mapping (false: a heap copy, or nothing).
+            bool mapped_;
+        
+        public:
+        
+            /// Maps the file; check isOpen() before reading.
+            /// @param randomAccess Whether reads will jump around the file (the default is front to back),
+            ///        so the system doesn't bother reading ahead.
+            explicit MappedFile(const std::string& path, bool randomAccess = false);
+            ~MappedFile();
+        
+            //disabled constructors & operators
+            MappedFile(const MappedFile& obj) = delete;
+            MappedFile& operator =(const MappedFile& obj) = delete;
+            MappedFile(MappedFile&& obj) = delete;
+            MappedFile& operator =(MappedFile&& obj) = delete;
+            MappedFile() = delete;
+        
+            /// False if the file couldn't be opened (an empty file is open, with size 0).
+            inline bool isOpen() const
+            {
+                return data_ != nullptr;
+            }
+        
+            inline const char* begin() const
+            {
+                return data_;
+            }
+        
+            inline const char* end() const
+            {
+                return data_ + size_;
+            }
+        
+            inline size_t size() const
+            {
+                return size_;
+            }
+    };
+}
+
+#endif //    MAPPED_FILE_H
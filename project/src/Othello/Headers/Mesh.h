@@ -0,0 +1,71 @@
+//
+//  Mesh.h
+//  Othello
+//
+//  Immutable geometry (vertices, normals and the primitives that use them),
+//  shared between every object drawn with the same shape.
+//
+
+#ifndef MESH_H
+#define MESH_H
+
+#include <memory>
+#include <vector>
+#include "glPlatform.h"
+#include "MeshBuffer.h"
+
+namespace graphics3d
+{
+    /// A run of consecutive vertices drawn as one primitive (a polygon, a strip, a fan...),
+    /// or, in an indexed mesh, a run of consecutive indices drawn as GL_TRIANGLES.
+    struct MeshPart
+    {
+        GLenum mode;
+        unsigned int first;
+        unsigned int count;
+    };
+
+    struct Mesh
+    {
+        /// Vertex positions, 3 floats per vertex.
+        std::vector<GLfloat> xyz;
+        /// One normal per vertex, same layout as xyz (empty if the mesh has no normals).
+        std::vector<GLfloat> normals;
+        /// The primitives, in drawing order.
+        std::vector<MeshPart> parts;
+        /// Empty, or the mesh is an indexed triangle list: 3 vertex indices per triangle, with the parts
+        /// pointing into it (see MeshOptimizer).
+        std::vector<GLuint> indices;
+
+        inline unsigned int numVertices() const
+        {
+            return (unsigned int)(xyz.size() / 3);
+        }
+
+        /// The GPU copy, uploaded on the first draw where buffer objects are available.
+        /// (It's also why a mesh can be moved but not copied.)
+        mutable std::unique_ptr<MeshBuffer> buffer;
+
+        /// Issues the mesh's primitives in the current coordinate system (the caller applies pose & material):
+        /// one glDrawElements from the GPU copy if the context has buffer objects, immediate mode otherwise.
+        void draw() const;
+
+        inline bool isIndexed() const
+        {
+            return !indices.empty();
+        }
+
+        /// The parts split into triangles, 3 vertex indices each (points & lines are left out).
+        std::vector<GLuint> triangleIndices() const;
+
+        /// How many triangles triangleIndices() would give, without building them.
+        unsigned int numTriangles() const;
+
+        /// Builds a mesh of polygons from OBJ-style lists.
+        /// @param vertices Vertex points, each one {x, y, z}.
+        /// @param faces Faces as lists of vertex indices, starting at 1 (like in obj files).
+        static Mesh fromFaces(const std::vector<std::vector<float>>& vertices, const std::vector<std::vector<int>>& faces);
+    };
+}
+
+#endif //    MESH_H
@@ -0,0 +1,64 @@
+//
+//  MeshAssetCache.h
+//  Othello
+//
+//  Process-wide registry of loaded meshes: each OBJ file (or procedural
+//  shape) is built once and shared by every object that uses it, for as long
+//  as one of them is alive.
+//
+
+#ifndef MESH_ASSET_CACHE_H
+#define MESH_ASSET_CACHE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "Mesh.h"
+#include "MeshOptimizer.h"
+
+namespace graphics3d
+{
+    class MeshAssetCache
+    {
+        public:
+        
+            //disabled constructors & operators
+            MeshAssetCache() = delete;
+            MeshAssetCache(const MeshAssetCache& obj) = delete;
+            MeshAssetCache& operator =(const MeshAssetCache& obj) = delete;
+            MeshAssetCache(MeshAssetCache&& obj) = delete;
+            MeshAssetCache& operator =(MeshAssetCache&& obj) = delete;
+            
+            /// Returns the mesh of an OBJ file, reading & parsing the file only if no live mesh already has its content.
+            /// A file that changed on disk since it was cached is loaded again.
+            /// A parsed file is also saved in binary next to itself (see BinaryMesh), and later loads
+            /// of the same content map that copy instead of parsing.
+            /// @param path The system filepath to the .obj file.
+            /// @return The shared mesh, or nullptr if the file can't be read.
+            static std::shared_ptr<const Mesh> loadObj(const std::string& path);
+            
+            /// What loadObj does with an OBJ file's content it has to parse: the mesh, with normals computed
+            /// if the file has none and, if optimizeMeshes(), optimized for indexed drawing (see MeshOptimizer).
+            /// @param report If not null, set to what the optimizer did (left alone when it didn't run).
+            static Mesh buildObj(const char* begin, const char* end, MeshOptimizerReport* report = nullptr);
+            
+            /// Returns the mesh registered under a name, building it if no live mesh has that name.
+            /// @param name Unique name of the shape and its parameters (e.g. "Cylinder3D 1 1 1 12 12 closed").
+            /// @param build Makes the mesh (only called on a miss, without holding the cache's lock).
+            static std::shared_ptr<const Mesh> getOrBuild(const std::string& name, const std::function<Mesh()>& build);
+            
+            /// Number of meshes currently alive (held by at least one object).
+            static size_t numLiveMeshes();
+            
+            /// Whether loadObj reads & writes binary copies (on by default).
+            static bool useBinaryCache();
+            static void setUseBinaryCache(bool useBinaryCache);
+            
+            /// Whether buildObj optimizes meshes (on by default, off with --no-optimize-meshes).
+            /// Binary copies only get used by a loader with the same setting.
+            static bool optimizeMeshes();
+            static void setOptimizeMeshes(bool optimizeMeshes);
+    };
+}
+
+#endif //    MESH_ASSET_CACHE_H
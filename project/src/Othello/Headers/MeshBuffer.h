@@ -0,0 +1,87 @@
+//
+//  MeshBuffer.h
+//  Othello
+//
+//  A mesh uploaded to the GPU: interleaved positions & normals in a vertex
+//  buffer plus a triangle index buffer, drawn with a single glDrawElements.
+//
+
+#ifndef MESH_BUFFER_H
+#define MESH_BUFFER_H
+
+#include <vector>
+#include "glPlatform.h"
+
+namespace graphics3d
+{
+    class MeshBuffer
+    {
+        private:
+        
+            GLuint vertexBuffer_;
+            GLuint indexBuffer_;
+            unsigned int numVertices_;
+            GLsizei numIndices_;
+            bool hasNormals_;
+            /// Interleaving space, kept so that re-uploads don't allocate.
+            std::vector<GLfloat> staging_;
+        
+            void interleave_(const GLfloat* xyz, const GLfloat* normals, unsigned int numVertices);
+        
+        public:
+        
+            MeshBuffer();
+            ~MeshBuffer();
+        
+            //disabled constructors & operators
+            MeshBuffer(const MeshBuffer& obj) = delete;
+            MeshBuffer& operator =(const MeshBuffer& obj) = delete;
+            MeshBuffer(MeshBuffer&& obj) = delete;
+            MeshBuffer& operator =(MeshBuffer&& obj) = delete;
+        
+            /// Whether the current context has buffer objects (GL 1.5). Without them, draw the mesh in immediate mode.
+            static bool available();
+        
+            inline bool isUploaded() const
+            {
+                return vertexBuffer_ != 0;
+            }
+        
+            /// Creates the buffers (or replaces their contents).
+            /// @param xyz Vertex positions, 3 floats per vertex.
+            /// @param normals One normal per vertex, or empty to draw with the current normal.
+            /// @param indices Triangles, 3 vertex indices each.
+            /// @param usage GL_STATIC_DRAW for geometry that never changes, GL_DYNAMIC_DRAW if it will be updated.
+            inline void upload(const std::vector<GLfloat>& xyz, const std::vector<GLfloat>& normals,
+                               const std::vector<GLuint>& indices, GLenum usage)
+            {
+                upload(xyz.data(), normals.empty() ? nullptr : normals.data(), (unsigned int)(xyz.size() / 3), indices, usage);
+            }
+        
+            inline void upload(const GLfloat* xyz, const GLfloat* normals, unsigned int numVertices,
+                               const std::vector<GLuint>& indices, GLenum usage)
+            {
+                upload(xyz, normals, numVertices, indices.data(), indices.size(), usage);
+            }
+        
+            /// Same, from raw arrays (normals may be nullptr), e.g. straight from a mapped file.
+            void upload(const GLfloat* xyz, const GLfloat* normals, unsigned int numVertices,
+                        const GLuint* indices, size_t numIndices, GLenum usage);
+        
+            /// Replaces the vertices only (same number of them, same triangles), e.g. after a vertex was displaced.
+            /// @param normals Must be nullptr if and only if the upload had no normals.
+            void updateVertices(const GLfloat* xyz, const GLfloat* normals);
+        
+            /// Draws all the triangles in the current coordinate system (the caller applies pose & material).
+            inline void draw() const
+            {
+                draw(0, numIndices_);
+            }
+        
+            /// Draws the triangles of indices [firstIndex, firstIndex + numIndices) only (e.g. one level of detail
+            /// out of several uploaded together).
+            void draw(size_t firstIndex, GLsizei numIndices) const;
+    };
+}
+
+#endif //    MESH_BUFFER_H
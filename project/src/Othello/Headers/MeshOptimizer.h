@@ -0,0 +1,75 @@
+//
+//  MeshOptimizer.h
+//  Othello
+//
+//  Rewrites a mesh for indexed drawing: one indexed triangle list, duplicate
+//  vertices welded, triangles ordered so that the GPU's post-transform cache
+//  reuses vertices (Forsyth's algorithm), and vertices stored in the order the
+//  triangles fetch them. Run once when a mesh is loaded, never while drawing.
+//
+
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include "Mesh.h"
+
+namespace graphics3d
+{
+    /// What optimize did. ACMR: vertices transformed per triangle, with a FIFO cache of
+    /// MeshOptimizer::ACMR_CACHE_SIZE vertices (3 = no reuse at all, around 0.6 is excellent).
+    struct MeshOptimizerReport
+    {
+        unsigned int verticesBefore;
+        unsigned int verticesAfter;
+        unsigned int numTriangles;
+        float acmrBefore;
+        float acmrAfter;
+    };
+
+    class MeshOptimizer
+    {
+        public:
+        
+            /// Vertices closer than this (in every coordinate) are welded.
+            static const float DEFAULT_WELD_TOLERANCE;
+            /// Normals must be this close (in every coordinate) for their vertices to be welded, so creases stay sharp.
+            static const float NORMAL_WELD_TOLERANCE;
+            /// The LRU cache Forsyth's scores model.
+            static const unsigned int FORSYTH_CACHE_SIZE;
+            /// The FIFO cache the ACMR is measured with (typical of post-transform caches).
+            static const unsigned int ACMR_CACHE_SIZE;
+        
+            //disabled constructors & operators
+            MeshOptimizer() = delete;
+            MeshOptimizer(const MeshOptimizer& obj) = delete;
+            MeshOptimizer& operator =(const MeshOptimizer& obj) = delete;
+            MeshOptimizer(MeshOptimizer&& obj) = delete;
+            MeshOptimizer& operator =(MeshOptimizer&& obj) = delete;
+        
+            /// All the steps below, in order. The mesh ends up as one indexed GL_TRIANGLES part (the
+            /// original parts' boundaries are lost: triangles move across them).
+            static MeshOptimizerReport optimize(Mesh& mesh, float weldTolerance = DEFAULT_WELD_TOLERANCE);
+        
+            /// Turns the parts (polygons, strips, fans, quads...) into an indexed triangle list over the same
+            /// vertices, one part per original part. Points & lines are dropped. Does nothing to an indexed mesh.
+            static void toIndexedTriangles(Mesh& mesh);
+        
+            /// Merges the vertices of an indexed mesh that have the same position & normal, and drops the
+            /// triangles that become degenerate.
+            static void weldVertices(Mesh& mesh, float tolerance = DEFAULT_WELD_TOLERANCE);
+        
+            /// Reorders triangles (3 indices each) for the post-transform cache (Tom Forsyth's linear-speed
+            /// vertex cache optimisation).
+            static void reorderTriangles(std::vector<GLuint>& indices, unsigned int numVertices);
+        
+            /// Renumbers the vertices of an indexed mesh in the order its triangles first use them (so fetches
+            /// go through memory in order), dropping unused ones.
+            static void reorderVertices(Mesh& mesh);
+        
+            /// Average number of vertices transformed per triangle when drawing 'indices' with a FIFO cache.
+            static float acmr(const std::vector<GLuint>& indices, unsigned int cacheSize = ACMR_CACHE_SIZE);
+    };
+}
+
+#endif //    MESH_OPTIMIZER_H
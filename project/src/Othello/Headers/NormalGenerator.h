@@ -0,0 +1,62 @@
+//
+//  NormalGenerator.h
+//  Othello
+//
+//  Vertex normals for meshes that come without them (procedural shapes, OBJ
+//  files with no vn lines): smooth normals weighted by the triangles around
+//  each vertex, split along edges sharper than a crease angle. Computed once
+//  when a mesh is built, never while drawing.
+//
+
+#ifndef NORMAL_GENERATOR_H
+#define NORMAL_GENERATOR_H
+
+#include "Mesh.h"
+#include "VertexGrid.h"
+
+namespace graphics3d
+{
+    /// How much each triangle around a vertex counts in its normal.
+    enum class NormalWeighting
+    {
+        /// By area: big triangles dominate.
+        AREA,
+        /// By the angle the triangle makes at the vertex: independent of how the surface is tessellated.
+        ANGLE
+    };
+
+    class NormalGenerator
+    {
+        public:
+        
+            /// Edges sharper than this stay sharp when no crease angle is given (a cube keeps flat sides,
+            /// a cylinder's side is smooth but its caps are not).
+            static const float DEFAULT_CREASE_ANGLE;
+            /// Meshes with at least this many vertices are processed on several threads.
+            static const unsigned int PARALLEL_THRESHOLD;
+        
+            //disabled constructors & operators
+            NormalGenerator() = delete;
+            NormalGenerator(const NormalGenerator& obj) = delete;
+            NormalGenerator& operator =(const NormalGenerator& obj) = delete;
+            NormalGenerator(NormalGenerator&& obj) = delete;
+            NormalGenerator& operator =(NormalGenerator&& obj) = delete;
+        
+            /// Replaces the normals of a mesh. Vertices at the same position are smoothed together
+            /// (meshes built face by face repeat them), except across edges sharper than the crease angle.
+            /// Vertices that belong to no triangle get {0, 0, 1}.
+            /// @param creaseAngle In degrees: 0 gives flat faces, 180 smooths everything.
+            static void computeNormals(Mesh& mesh, float creaseAngle = DEFAULT_CREASE_ANGLE,
+                                       NormalWeighting weighting = NormalWeighting::ANGLE);
+        
+            /// Computes all the normals of a grid (triangulated the way QuadMesh3D draws it). For a grid whose
+            /// columns go along +X and rows along +Y, like QuadMesh3D's, they point to +Z.
+            static void computeGridNormals(VertexGrid& grid, NormalWeighting weighting = NormalWeighting::ANGLE);
+        
+            /// Recomputes only the normals that moving one vertex changes: its own and its 8 neighbors'.
+            static void updateGridNormals(VertexGrid& grid, unsigned int row, unsigned int col,
+                                          NormalWeighting weighting = NormalWeighting::ANGLE);
+    };
+}
+
+#endif //    NORMAL_GENERATOR_H
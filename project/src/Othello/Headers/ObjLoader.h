@@ -0,0 +1,80 @@
+//
+//  ObjLoader.h
+//  Othello
+//
+//  Wavefront OBJ parser: v/vt/vn, faces in any of the v, v/t, v//n, v/t/n
+//  forms (negative indices included), n-gons split into triangles, and
+//  o/g groups. Large files are cut into chunks parsed on several threads.
+//
+
+#ifndef OBJ_LOADER_H
+#define OBJ_LOADER_H
+
+#include <string>
+#include <vector>
+#include "Mesh.h"
+
+namespace graphics3d
+{
+    /// One corner of a triangle: indices (from 0) into the ObjData arrays, -1 if the face didn't give one.
+    struct ObjCorner
+    {
+        int position;
+        int texCoord;
+        int normal;
+    };
+
+    /// A named run of consecutive triangles (an 'o' or 'g' line and the faces after it).
+    struct ObjGroup
+    {
+        std::string name;
+        unsigned int firstTriangle;
+        unsigned int numTriangles;
+    };
+
+    struct ObjData
+    {
+        /// 3 floats per position/normal, 2 per texture coordinate (u, v).
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> texCoords;
+        /// 3 corners per triangle.
+        std::vector<ObjCorner> corners;
+        /// Faces before the first 'o'/'g' line go in a group named "default".
+        std::vector<ObjGroup> groups;
+        
+        inline unsigned int numTriangles() const
+        {
+            return (unsigned int)(corners.size() / 3);
+        }
+    };
+
+    class ObjLoader
+    {
+        public:
+        
+            /// Files at least this big are parsed in parallel chunks.
+            static const size_t PARALLEL_THRESHOLD;
+        
+            //disabled constructors & operators
+            ObjLoader() = delete;
+            ObjLoader(const ObjLoader& obj) = delete;
+            ObjLoader& operator =(const ObjLoader& obj) = delete;
+            ObjLoader(ObjLoader&& obj) = delete;
+            ObjLoader& operator =(ObjLoader&& obj) = delete;
+        
+            /// Parses OBJ text. Unknown statements (usemtl, s, l...) and malformed lines are skipped.
+            /// @param numThreads 0 to pick from the size of the text and the number of cores.
+            static ObjData parse(const char* begin, const char* end, unsigned int numThreads = 0);
+        
+            /// Maps & parses a file.
+            /// @return false if the file can't be opened.
+            static bool load(const std::string& path, ObjData& data);
+        
+            /// Builds a mesh of triangles with one part per group.
+            /// Normals are kept only if every corner has one (otherwise the mesh has none, like before).
+            static Mesh toMesh(const ObjData& data);
+    };
+}
+
+#endif //    OBJ_LOADER_H
@@ -0,0 +1,68 @@
+//
+//  ObjectBVH.h
+//  Othello
+//
+//  Bounding volume hierarchy over objects that don't move, so that culling
+//  thousands of them tests a few boxes instead of every object.
+//
+
+#ifndef OBJECT_BVH_H
+#define OBJECT_BVH_H
+
+#include <memory>
+#include <vector>
+#include "Frustum.h"
+
+namespace graphics3d
+{
+    class ObjectBVH
+    {
+        private:
+        
+            struct Node_
+            {
+                Bounds3D bounds;
+                /// The node's objects are objects_[first, first + count).
+                unsigned int first;
+                unsigned int count;
+                /// Index of the second child (the first one follows the node); 0 for a leaf.
+                unsigned int secondChild;
+            };
+        
+            std::vector<Node_> nodes_;
+            /// Reordered so that every node's objects are contiguous.
+            std::vector<std::shared_ptr<GraphicObject3D>> objects_;
+            /// Objects without bounds: drawn every time.
+            std::vector<std::shared_ptr<GraphicObject3D>> unbounded_;
+        
+            unsigned int build_(unsigned int first, unsigned int count);
+        
+        public:
+        
+            /// Leaves hold at most this many objects.
+            static const unsigned int LEAF_SIZE;
+        
+            /// Creates an empty hierarchy.
+            ObjectBVH();
+        
+            //disabled constructors & operators
+            ObjectBVH(const ObjectBVH& obj) = delete;
+            ObjectBVH& operator =(const ObjectBVH& obj) = delete;
+            ObjectBVH(ObjectBVH&& obj) = delete;
+            ObjectBVH& operator =(ObjectBVH&& obj) = delete;
+        
+            /// Builds the hierarchy from where the objects are now (build it again after moving any of them).
+            void build(const std::vector<std::shared_ptr<GraphicObject3D>>& objects);
+        
+            /// Appends the objects that may be seen to 'visible': whole subtrees are accepted or rejected
+            /// at once when their box is inside or outside the frustum.
+            void cull(const Frustum& frustum, std::vector<GraphicObject3D*>& visible, CullStats& stats) const;
+        
+            inline size_t size() const
+            {
+                return objects_.size() + unbounded_.size();
+            }
+    };
+}
+
+#endif //    OBJECT_BVH_H
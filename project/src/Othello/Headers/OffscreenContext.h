@@ -0,0 +1,68 @@
+//
+//  OffscreenContext.h
+//  Othello
+//
+//  An OpenGL context that renders into memory instead of a window (surfaceless
+//  EGL, e.g. Mesa's llvmpipe), so rendering can be timed on a machine without
+//  a display or a GPU.
+//
+
+#ifndef OFFSCREEN_CONTEXT_H
+#define OFFSCREEN_CONTEXT_H
+
+#include <vector>
+#include "glPlatform.h"
+
+namespace graphics3d
+{
+    class OffscreenContext
+    {
+        private:
+        
+            /// libEGL, opened at run time so that the windowed program doesn't need it.
+            void* library_;
+            void* display_;
+            void* surface_;
+            void* context_;
+            unsigned int width_;
+            unsigned int height_;
+        
+            /// Creates the display, surface & context (false, with a message, if any step fails).
+            bool create_();
+        
+        public:
+        
+            /// Creates a context with a width x height RGBA + depth buffer, and makes it current.
+            /// Check isValid: it fails where EGL isn't installed (it's only tried on Linux & co).
+            OffscreenContext(unsigned int width, unsigned int height);
+        
+            ~OffscreenContext();
+        
+            //disabled constructors & operators
+            OffscreenContext() = delete;
+            OffscreenContext(const OffscreenContext& obj) = delete;
+            OffscreenContext& operator =(const OffscreenContext& obj) = delete;
+            OffscreenContext(OffscreenContext&& obj) = delete;
+            OffscreenContext& operator =(OffscreenContext&& obj) = delete;
+        
+            inline bool isValid() const
+            {
+                return context_ != nullptr;
+            }
+        
+            inline unsigned int getWidth() const
+            {
+                return width_;
+            }
+        
+            inline unsigned int getHeight() const
+            {
+                return height_;
+            }
+        
+            /// Waits for the rendering to finish and copies the color buffer (RGBA, bottom row first).
+            void readPixels(std::vector<unsigned char>& rgba) const;
+    };
+}
+
+#endif //    OFFSCREEN_CONTEXT_H
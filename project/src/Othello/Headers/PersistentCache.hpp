@@ -0,0 +1,89 @@
+//
+//  PersistentCache.hpp
+//  Othello
+//
+//  Read-only second-level cache of deep search results, memory-mapped from a
+//  snapshot file written at the end of the previous session.
+//
+
+#ifndef PersistentCache_hpp
+#define PersistentCache_hpp
+
+#include <cstdint>
+#include <memory>
+#include "MappedFile.h"
+#include "TranspositionTable.hpp"
+
+namespace othello {
+
+    /// Snapshot file layout: this header, then numEntries TTEntry records sorted by key (native byte order).
+    struct CacheFileHeader {
+        char magic[8];
+        /// Bumped whenever the entry layout or the evaluation changes, which makes older files unusable.
+        uint32_t version;
+        uint32_t entrySize;
+        uint64_t numEntries;
+        /// Fingerprint of the evaluation weights the scores were computed with (see AiMind::evalFingerprint).
+        uint64_t fingerprint;
+    };
+
+    class PersistentCache {
+    private:
+        /// The mapped file (nullptr if none is open).
+        std::unique_ptr<graphics3d::MappedFile> file_;
+        /// The sorted entries, inside the mapping.
+        const TTEntry* entries_;
+        uint64_t numEntries_;
+
+        static const char MAGIC_[8];
+        static const uint32_t VERSION_;
+
+        /// Unmaps the current file, if any.
+        void close_();
+
+    public:
+        /// Only results searched at least this deep are worth writing out.
+        static const unsigned int MIN_SAVE_DEPTH;
+
+        /// Creates an empty cache (every probe misses until a file is opened).
+        PersistentCache();
+
+        //disabled constructors & operators
+        PersistentCache(const PersistentCache& obj) = delete;   // copy
+        PersistentCache(PersistentCache&& obj) = delete;        // move
+        PersistentCache& operator = (const PersistentCache& obj) = delete;    // copy operator
+        PersistentCache& operator = (PersistentCache&& obj) = delete;        // move operator
+
+        ~PersistentCache();
+
+        /// Maps a snapshot file. A missing file is not an error (the cache just stays empty);
+        /// a file with the wrong version or fingerprint is ignored.
+        /// @param filepath The system filepath to the snapshot.
+        /// @param fingerprint The fingerprint of the evaluation that will use the results.
+        /// @return Whether a usable snapshot was mapped.
+        bool open(const char* filepath, uint64_t fingerprint);
+
+        /// Looks a position up (binary search over the sorted entries).
+        /// @param key The position's key, as built by TranspositionTable::key.
+        /// @param entry Set to the stored result if there is one.
+        /// @return Whether the position was found.
+        bool probe(uint64_t key, TTEntry& entry) const;
+
+        /// Writes a new snapshot: the deep entries of the table merged with the entries of the currently
+        /// mapped snapshot (the deeper result wins when both hold a position). When there are more than
+        /// maxEntries, the shallowest ones are dropped. The file is replaced atomically, so a crash
+        /// while saving never leaves a truncated snapshot behind.
+        /// @param filepath The system filepath to write (usually the one that was opened).
+        /// @param table The first-level table to take the new results from.
+        /// @param fingerprint The fingerprint of the evaluation that computed the results.
+        /// @param maxEntries Upper bound on the number of entries in the file.
+        /// @return The number of entries written (0 on failure).
+        size_t save(const char* filepath, const TranspositionTable& table, uint64_t fingerprint, size_t maxEntries) const;
+
+        inline uint64_t size() const {
+            return numEntries_;
+        }
+    };
+}
+
+#endif /* PersistentCache_hpp */
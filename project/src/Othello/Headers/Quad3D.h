@@ -34,7 +34,7 @@ namespace graphics3d
             Quad3D& operator =(Quad3D&& obj) = delete;
             Quad3D() = delete;
 
-            void draw() const;
+            void drawShape() const;
             
             inline float getWidth()
             {
@@ -9,7 +9,11 @@
 #define QUAD_MESH_3D_H
 
 #include <memory>
+#include <vector>
 #include "GraphicObject3D.h"
+#include "MeshBuffer.h"
+#include "VertexGrid.h"
+#include "LevelOfDetail.h"
 
 namespace graphics3d
 {
@@ -22,28 +26,45 @@ namespace graphics3d
         
             float width_;
             float height_;
-            unsigned int numRows_;
-            unsigned int numCols_;
-            //    Switching back to a pointer, but I make it a 3D array
-            //    numRows x numCols x 3
-            GLfloat*** XYZ_;
-            GLfloat*** normal_;
+            //    numRows x numCols vertices, each block in one piece
+            //    (see VertexGrid)
+            VertexGrid grid_;
+            //    GPU copy of the grid, refreshed on the next draw after
+            //    a vertex was displaced
+            mutable MeshBuffer buffer_;
+            mutable bool bufferValid_;
+            //    Coarser levels of detail skip rows & columns of the same grid (so they follow
+            //    displaced vertices too): every lodSteps_[level] one, plus the last one.
+            //    All the levels' triangles are in the one index buffer, one range each
+            std::vector<unsigned int> lodSteps_;
+            std::vector<size_t> lodFirstIndex_;
+            LevelOfDetail lod_;
+        
+            /// The rows (or columns) out of 'count' a level keeps.
+            static std::vector<unsigned int> sampledLines_(unsigned int count, unsigned int step);
+        
+            /// Appends a level's row strips as triangles (same winding as the immediate path).
+            void appendGridIndices_(unsigned int step, std::vector<GLuint>& indices) const;
+        
+            /// Sets up the levels, once the grid's size is known.
+            void buildLevels_();
             
         public:
         
+            /// The most levels of detail a mesh gets (including the full grid).
+            static const unsigned int MAX_LOD_LEVELS;
+        
             QuadMesh3D(float width, float height, unsigned int numRows, unsigned int numCols, const Pose& pose, const Motion& motion = Motion::NULL_MOTION);
 
             QuadMesh3D(float width, float height, unsigned int numRows, unsigned int numCols, float perturbationAmplitude, const Pose& pose, const Motion& motion = Motion::NULL_MOTION);
     
-            ~QuadMesh3D();
-            
             QuadMesh3D(const QuadMesh3D& obj) = delete;
             QuadMesh3D& operator =(const QuadMesh3D& obj) = delete;
             QuadMesh3D(QuadMesh3D&& obj) = delete;
             QuadMesh3D& operator =(QuadMesh3D&& obj) = delete;
             QuadMesh3D() = delete;
 
-            void draw() const;
+            void drawShape() const;
             
             inline float getWidth()
             {
@@ -55,9 +76,19 @@ namespace graphics3d
                 return height_;
             }
             
+            inline const VertexGrid& getGrid() const
+            {
+                return grid_;
+            }
+            
+            inline const LevelOfDetail& getLevelOfDetail() const
+            {
+                return lod_;
+            }
+            
             void displaceVertex(unsigned int row, unsigned int col, float dZ);
             
-            void faceNormal(GLfloat* v1, GLfloat* v2, GLfloat* v3, GLfloat* v4,
+            void faceNormal(const GLfloat* v1, const GLfloat* v2, const GLfloat* v3, const GLfloat* v4,
                             float normal[]) const;
     };
 }
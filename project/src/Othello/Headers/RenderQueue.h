@@ -0,0 +1,64 @@
+//
+//  RenderQueue.h
+//  Othello
+//
+//  Collects the objects to draw in a frame and draws them in an order that
+//  changes the GL state as little as possible: opaque objects grouped by
+//  material and front to back (so hidden pixels fail the depth test early),
+//  then transparent ones back to front.
+//
+
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+#include "GraphicObject3D.h"
+
+namespace graphics3d
+{
+    class RenderQueue
+    {
+        private:
+        
+            struct Item_
+            {
+                /// Sorting this sorts the items in drawing order (see makeKey_).
+                uint64_t key;
+                const GraphicObject3D* object;
+            };
+        
+            std::vector<Item_> items_;
+            /// Third row of the view matrix: an object's depth is its center's dot product with it.
+            GLfloat depthRow_[4];
+        
+            static uint64_t makeKey_(bool isTransparent, unsigned int materialId, float depth);
+        
+        public:
+        
+            RenderQueue();
+        
+            //disabled constructors & operators
+            RenderQueue(const RenderQueue& obj) = delete;
+            RenderQueue& operator =(const RenderQueue& obj) = delete;
+            RenderQueue(RenderQueue&& obj) = delete;
+            RenderQueue& operator =(RenderQueue&& obj) = delete;
+        
+            /// Empties the queue and reads the current modelview matrix as the view the depths are measured
+            /// from (call it in the frame the objects will be drawn in, e.g. right after cameraToWorld).
+            void begin();
+        
+            /// Queues an object (drawn by submit, so it must live until then).
+            void add(const GraphicObject3D& object);
+        
+            /// Sorts & draws the queued objects, then empties the queue.
+            void submit();
+        
+            inline size_t size() const
+            {
+                return items_.size();
+            }
+    };
+}
+
+#endif //    RENDER_QUEUE_H
@@ -0,0 +1,113 @@
+//
+//  SceneNode.h
+//  Othello
+//
+//  A hierarchy of poses (a vehicle and its wheels, the board and its discs)
+//  that keeps every node's world matrix, so a frame only recomputes the ones
+//  under a pose that changed, and draws each object by loading its matrix.
+//
+
+#ifndef SCENE_NODE_H
+#define SCENE_NODE_H
+
+#include <memory>
+#include <vector>
+#include "GraphicObject3D.h"
+
+namespace graphics3d
+{
+    class SceneNode
+    {
+        private:
+        
+            /// Relative to the parent node. A node with an object sets the object's pose to its world pose
+            /// on update, so the object can also be culled, queued & given its level of detail like any other.
+            Pose pose_;
+            /// What's drawn at this node (none for a node that only groups its children).
+            std::shared_ptr<GraphicObject3D> object_;
+            SceneNode* parent_;
+            std::vector<std::unique_ptr<SceneNode>> children_;
+            //    Column-major matrices: the pose, and the product of all poses from the root
+            GLfloat localMatrix_[16];
+            GLfloat worldMatrix_[16];
+            bool localDirty_;
+            /// A dirty node's descendants are all dirty too.
+            bool worldDirty_;
+            /// Some descendant is dirty (so an update has to go down this branch).
+            bool hasDirtyDescendant_;
+        
+            /// World matrices recomputed since the program started.
+            static unsigned long numMatrixUpdates_;
+        
+            void markWorldDirty_();
+            void updateWorld_();
+            void draw_(const GLfloat view[16]) const;
+        
+        public:
+        
+            /// Creates a node (the root of its own hierarchy until it's added to a parent).
+            SceneNode(const Pose& pose, std::shared_ptr<GraphicObject3D> object = nullptr);
+        
+            //disabled constructors & operators
+            SceneNode() = delete;
+            SceneNode(const SceneNode& obj) = delete;
+            SceneNode& operator =(const SceneNode& obj) = delete;
+            SceneNode(SceneNode&& obj) = delete;
+            SceneNode& operator =(SceneNode&& obj) = delete;
+        
+            /// Creates a child of this node and gives it back (it's owned by this node).
+            SceneNode& addChild(const Pose& pose, std::shared_ptr<GraphicObject3D> object = nullptr);
+        
+            inline const Pose& getPose() const
+            {
+                return pose_;
+            }
+        
+            /// Moves the node (and so everything under it) relative to its parent.
+            void setPose(const Pose& pose);
+        
+            inline const std::shared_ptr<GraphicObject3D>& getObject() const
+            {
+                return object_;
+            }
+        
+            inline SceneNode* getParent() const
+            {
+                return parent_;
+            }
+        
+            inline size_t numChildren() const
+            {
+                return children_.size();
+            }
+        
+            inline SceneNode& getChild(size_t index) const
+            {
+                return *children_[index];
+            }
+        
+            /// Recomputes the world matrices (and the objects' poses) of the nodes that moved (or whose ancestors did),
+            /// and only those. Call it on the root, before drawing.
+            void update();
+        
+            /// The product of the poses from the root down to this node (valid after update).
+            inline const GLfloat* getWorldMatrix() const
+            {
+                return worldMatrix_;
+            }
+        
+            /// Updates, then draws the objects of this node & its descendants: each one with its world matrix
+            /// loaded straight onto the current modelview matrix (the root's frame, e.g. the world's).
+            void draw();
+        
+            static inline unsigned long numMatrixUpdates()
+            {
+                return numMatrixUpdates_;
+            }
+        
+            /// c = a x b, column-major 4x4 (c must not be a or b).
+            static void multiply(const GLfloat a[16], const GLfloat b[16], GLfloat c[16]);
+    };
+}
+
+#endif //    SCENE_NODE_H
@@ -0,0 +1,80 @@
+//
+//  SearchArena.hpp
+//  Othello
+//
+//  Per-thread scratch memory for the search: one preallocated slot per ply for
+//  the move list and the principal variation, so searching a node never
+//  touches the heap.
+//
+
+#ifndef SearchArena_hpp
+#define SearchArena_hpp
+
+#include <cstdint>
+#include <vector>
+#include "BitBoard.hpp"
+
+// Set to 1 (e.g. -DOTHELLO_COUNT_ALLOCATIONS=1) in the benchmark build to replace the global operator new
+// & delete with counting versions (see SearchArena::heapAllocations). Off in the game's build.
+#ifndef OTHELLO_COUNT_ALLOCATIONS
+#define OTHELLO_COUNT_ALLOCATIONS 0
+#endif
+
+namespace othello {
+
+    /// The scratch buffers of one ply of the search.
+    struct PlyScratch {
+        /// Moves of the node being searched at this ply, in the order they're tried.
+        int moves[BitBoard::NUM_SQUARES];
+        int numMoves;
+        /// Best line found from this ply on (a row of the triangular PV table).
+        int pv[BitBoard::NUM_SQUARES + 1];
+        int pvLength;
+    };
+
+    class SearchArena {
+    private:
+        /// Preallocated once for the deepest possible search (every empty square filled, plus the leaf).
+        std::vector<PlyScratch> plies_;
+
+        SearchArena();
+
+    public:
+        /// The deepest ply a search can reach.
+        static const unsigned int MAX_PLY;
+        /// Whether this build counts heap allocations (OTHELLO_COUNT_ALLOCATIONS).
+        static const bool COUNTS_ALLOCATIONS;
+
+        //disabled constructors & operators
+        SearchArena(const SearchArena& obj) = delete;   // copy
+        SearchArena(SearchArena&& obj) = delete;        // move
+        SearchArena& operator = (const SearchArena& obj) = delete;    // copy operator
+        SearchArena& operator = (SearchArena&& obj) = delete;        // move operator
+
+        /// The calling thread's arena (created, and its memory allocated, the first time a thread asks for it).
+        static SearchArena& local();
+
+        /// The scratch buffers of a ply (0 = the root).
+        inline PlyScratch& ply(unsigned int p) {
+            return plies_[p];
+        }
+
+        /// Sets the PV of a ply to 'move' followed by the PV of the next ply.
+        inline void updatePv(unsigned int p, int move) {
+            PlyScratch& line = plies_[p];
+            const PlyScratch& child = plies_[p + 1];
+            line.pv[0] = move;
+            for (int i = 0; i < child.pvLength; i++)
+                line.pv[i + 1] = child.pv[i];
+            line.pvLength = child.pvLength + 1;
+        }
+
+        /// Heap allocations made by the calling thread so far. Compare two readings around some code to check
+        /// that it doesn't allocate (e.g. that the search loop runs entirely out of the arena).
+        /// Counted by the global operator new & its variants, replaced in SearchArena.cpp when
+        /// COUNTS_ALLOCATIONS is set (always 0 otherwise).
+        static uint64_t heapAllocations();
+    };
+}
+
+#endif /* SearchArena_hpp */
@@ -0,0 +1,105 @@
+//
+//  SelfPlayFarm.hpp
+//  Othello
+//
+//  Coordinator for long self-play runs: forks worker processes, hands them
+//  games over Unix domain sockets and collects the scored positions.
+//
+
+#ifndef SelfPlayFarm_hpp
+#define SelfPlayFarm_hpp
+
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include <sys/types.h>
+#include "AiMind.hpp"
+
+namespace othello {
+
+    /// One searched position of a self-play game.
+    struct TrainingPosition {
+        BitBoard position;
+        uint8_t blackToMove;
+        /// Search score from the point of view of the side to move.
+        int32_t score;
+    };
+
+    class SelfPlayFarm {
+    private:
+        /// A forked worker and the coordinator's end of its socket.
+        struct Worker_ {
+            pid_t pid;
+            int fd;
+            /// The game the worker is playing, or -1 if it's waiting for one.
+            int64_t gameIndex;
+        };
+
+        /// Coordinator -> worker: play this game.
+        struct Assignment_ {
+            uint32_t gameIndex;
+        };
+
+        /// Worker -> coordinator: a finished game, followed by numPositions TrainingPosition records.
+        struct ResultHeader_ {
+            uint32_t gameIndex;
+            uint32_t numPositions;
+            /// Final disc count difference, black minus white.
+            int32_t finalDiscDiff;
+        };
+
+        const unsigned int numWorkers_;
+        /// Minimax depth of every self-play move.
+        const unsigned int depth_;
+        std::vector<Worker_> workers_;
+
+        /// Number of random moves played at the start of every game, so the games don't all repeat each other.
+        static const int RANDOM_OPENING_PLIES_;
+        /// Worker crashes tolerated over a whole run before giving up (a crash in every game is a bug, not bad luck).
+        static const unsigned int MAX_RESTARTS_PER_WORKER_;
+
+        /// Forks a new worker process, connected to the coordinator by a socket pair.
+        /// @return false if the socket or the process couldn't be created.
+        bool spawnWorker_(Worker_& worker);
+
+        /// Reaps a dead worker and forks its replacement.
+        /// @return false if the replacement couldn't be started.
+        bool restartWorker_(Worker_& worker);
+
+        /// Body of a worker process: plays the games it's sent until the coordinator closes the socket.
+        void workerMain_(int fd) const;
+
+        /// Plays one self-play game, recording every searched position.
+        /// @return The final disc count difference (black minus white).
+        int playGame_(AiMind& mind, uint32_t gameIndex, std::vector<TrainingPosition>& positions) const;
+
+        /// Writes a finished game to the output, one tab-separated line per position.
+        static void writeGame_(std::ofstream& output, const ResultHeader_& header, const std::vector<TrainingPosition>& positions);
+
+        /// Blocking read/write of exactly 'size' bytes (sockets can transfer less than asked for).
+        static bool readFully_(int fd, void* data, size_t size);
+        static bool writeFully_(int fd, const void* data, size_t size);
+
+    public:
+        /// @param numWorkers How many worker processes to fork (0 = one per core).
+        /// @param depth The minimax depth of every self-play move.
+        SelfPlayFarm(unsigned int numWorkers, unsigned int depth);
+
+        //disabled constructors & operators
+        SelfPlayFarm() = delete;
+        SelfPlayFarm(const SelfPlayFarm& obj) = delete;   // copy
+        SelfPlayFarm(SelfPlayFarm&& obj) = delete;        // move
+        SelfPlayFarm& operator = (const SelfPlayFarm& obj) = delete;    // copy operator
+        SelfPlayFarm& operator = (SelfPlayFarm&& obj) = delete;        // move operator
+
+        /// Plays games 0 .. numGames-1 on the workers and writes their positions to the output file as each game
+        /// completes. A worker that dies is restarted and its game is handed out again; finished games are
+        /// already on disk, so they're never lost.
+        /// @param numGames How many games to play.
+        /// @param outputPath The system filepath of the file to write.
+        /// @return The number of games completed.
+        size_t run(unsigned int numGames, const char* outputPath);
+    };
+}
+
+#endif /* SelfPlayFarm_hpp */
@@ -0,0 +1,145 @@
+//
+//  SessionManager.hpp
+//  Othello
+//
+//  Hosts many human-vs-AI games in one process: compact per-game states, and
+//  a fixed pool of worker threads that serves the queued AI move requests.
+//
+
+#ifndef SessionManager_hpp
+#define SessionManager_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "AiMind.hpp"
+
+namespace othello {
+
+    /// How much search one AI move of a session may use (0 means "no limit" for every field).
+    struct SessionBudget {
+        unsigned int maxDepth;
+        uint64_t maxNodes;
+        double maxSeconds;
+    };
+
+    /// Throughput and latency of the AI move requests served so far.
+    struct HostingReport {
+        size_t movesServed;
+        double seconds;
+        double movesPerSecond;
+        /// Time from a request being queued to its move being played, in milliseconds.
+        double latencyP50;
+        double latencyP95;
+        double latencyP99;
+        double latencyMax;
+    };
+
+    class SessionManager {
+    public:
+        /// Called on a worker thread once the AI has played: the session, and the move (-1 for a pass).
+        typedef std::function<void(uint32_t sessionId, int move)> MoveCallback;
+
+    private:
+        /// Everything a game needs between moves (about 40 bytes, so thousands of games are cheap to keep).
+        struct Session_ {
+            BitBoard position;
+            bool blackToMove;
+            bool aiPlaysBlack;
+            /// Set while an AI move is queued or being searched for this game.
+            bool aiMovePending;
+            SessionBudget budget;
+        };
+
+        struct Request_ {
+            uint32_t sessionId;
+            std::chrono::steady_clock::time_point queuedAt;
+            MoveCallback onMove;
+        };
+
+        std::unordered_map<uint32_t, Session_> sessions_;
+        uint32_t nextSessionId_;
+
+        /// Requests are served in the order they were made. A game can only have one request queued
+        /// (it's only ever the AI's turn once), so no game can get ahead of the others.
+        std::deque<Request_> queue_;
+
+        /// Guards sessions_, queue_ & the counters below.
+        mutable std::mutex lock_;
+        std::condition_variable workAvailable_;
+        std::condition_variable idle_;
+        unsigned int numBusyWorkers_;
+
+        std::vector<std::thread> workers_;
+        /// Set to shut the pool down (it also aborts the searches in progress).
+        std::atomic<bool> stopping_;
+
+        /// Read-only resources shared by every worker's AI.
+        std::shared_ptr<const PersistentCache> sharedCache_;
+
+        /// Request latencies in milliseconds, when the first request was made and when the last one was served.
+        mutable std::mutex statsLock_;
+        std::vector<float> latencies_;
+        std::chrono::steady_clock::time_point firstRequest_;
+        std::chrono::steady_clock::time_point lastServed_;
+
+        /// Body of every worker thread: takes requests off the queue until the manager shuts down.
+        void workerLoop_();
+
+        /// Skips the turn of the side to move when they have no legal move (but the game isn't over).
+        static void skipForcedPass_(Session_& session);
+
+    public:
+        /// Starts the worker pool.
+        /// @param numWorkers How many searches run at the same time (0 = one per core).
+        /// @param sharedCache Optional cache of results from previous sessions, used by every worker.
+        SessionManager(unsigned int numWorkers, const std::shared_ptr<const PersistentCache>& sharedCache = nullptr);
+
+        //disabled constructors & operators
+        SessionManager() = delete;
+        SessionManager(const SessionManager& obj) = delete;   // copy
+        SessionManager(SessionManager&& obj) = delete;        // move
+        SessionManager& operator = (const SessionManager& obj) = delete;    // copy operator
+        SessionManager& operator = (SessionManager&& obj) = delete;        // move operator
+
+        /// Stops the workers. Queued requests are dropped and searches in progress are abandoned.
+        ~SessionManager();
+
+        /// Starts a new game from the initial position.
+        /// @param aiPlaysBlack Whether the AI has the first move.
+        /// @param budget The search budget of each of the AI's moves.
+        /// @return The new session's id.
+        uint32_t createSession(bool aiPlaysBlack, const SessionBudget& budget);
+
+        /// Ends a game. A pending AI move for it is dropped.
+        void closeSession(uint32_t sessionId);
+
+        /// Plays the human's move.
+        /// @return false if the session doesn't exist, it isn't the human's turn, or the move is illegal.
+        bool playMove(uint32_t sessionId, int sq);
+
+        /// Queues a search for the AI's move; the move is played on the session before onMove is called.
+        /// @return false if the session doesn't exist, it isn't the AI's turn, or a request is already pending.
+        bool requestAiMove(uint32_t sessionId, const MoveCallback& onMove);
+
+        /// Copies a session's current position.
+        /// @return false if the session doesn't exist.
+        bool getPosition(uint32_t sessionId, BitBoard& pos, bool& blackToMove) const;
+
+        /// Whether neither player can move any more.
+        static bool isGameOver(const BitBoard& pos);
+
+        /// Waits until the queue is empty and every worker is idle.
+        void waitIdle();
+
+        /// Throughput and latency percentiles of the requests served so far.
+        HostingReport report() const;
+    };
+}
+
+#endif /* SessionManager_hpp */
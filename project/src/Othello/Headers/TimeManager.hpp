@@ -0,0 +1,90 @@
+//
+//  TimeManager.hpp
+//  Othello
+//
+//  Splits a whole-game clock into per-move search budgets, and decides after
+//  every iterative-deepening iteration whether another one is worth starting.
+//
+
+#ifndef TimeManager_hpp
+#define TimeManager_hpp
+
+#include "AiMind.hpp"
+
+namespace othello {
+
+    /// What is left on a player's clock when they're asked to move.
+    struct GameClock {
+        /// Time left for the rest of the game.
+        double remainingSeconds;
+        /// Time added to the clock after every move (0 for sudden death).
+        double incrementSeconds;
+    };
+
+    class TimeManager {
+    private:
+        /// Time the search aims to use for this move, before it gets scaled by how the search is going.
+        double softLimit_;
+        /// Time the search may never exceed (passed on to the search as SearchLimits::maxSeconds).
+        double hardLimit_;
+        /// Multiplier on softLimit_, raised when the search looks unsettled and lowered when it looks decided.
+        double scale_;
+
+        /// What the previous iteration found.
+        int lastBestMove_;
+        int lastScore_;
+        double lastIterationSeconds_;
+        double lastElapsed_;
+        /// Number of iterations in a row that picked the same best move.
+        unsigned int stableIterations_;
+
+        /// Time kept on the clock at all times, so we never flag because of process or protocol overhead.
+        static const double RESERVE_SECONDS_;
+        /// Moves we plan for at least, even late in the game (passes can make games run longer than expected).
+        static const int MIN_MOVES_LEFT_;
+        /// Share of the increment that is spent on the current move.
+        static const double INCREMENT_SHARE_;
+        /// Most of the remaining clock a single move may use.
+        static const double MAX_CLOCK_SHARE_;
+        /// Bounds for scale_ (the hard limit is MAX_SCALE_ times the soft limit).
+        static const double MIN_SCALE_;
+        static const double MAX_SCALE_;
+        /// scale_ factors applied when the best move changes, when the score drops by SCORE_DROP_ or more,
+        /// and when a stable best move leads the runner-up by DOMINANCE_MARGIN_ or more.
+        static const double BEST_MOVE_CHANGE_FACTOR_;
+        static const double SCORE_DROP_FACTOR_;
+        static const double DOMINANT_FACTOR_;
+        static const int SCORE_DROP_;
+        static const int DOMINANCE_MARGIN_;
+        /// How much longer each iteration is expected to take than the previous one, when we have no measurement yet.
+        static const double DEFAULT_GROWTH_;
+
+    public:
+        /// Allocates the time for one move.
+        /// @param clock The mover's clock.
+        /// @param numEmpties Number of empty squares on the board, used to estimate how many moves are left to play.
+        TimeManager(const GameClock& clock, int numEmpties);
+
+        //disabled constructors & operators
+        TimeManager() = delete;
+        TimeManager(const TimeManager& obj) = delete;   // copy
+        TimeManager(TimeManager&& obj) = delete;        // move
+        TimeManager& operator = (const TimeManager& obj) = delete;    // copy operator
+        TimeManager& operator = (TimeManager&& obj) = delete;        // move operator
+
+        /// Meant to be called from AiMind::searchIterative's onIteration callback.
+        /// @param info The iteration that just completed.
+        /// @return Whether to start the next iteration.
+        bool continueSearch(const SearchInfo& info);
+
+        inline double getSoftLimit() const {
+            return softLimit_;
+        }
+
+        inline double getHardLimit() const {
+            return hardLimit_;
+        }
+    };
+}
+
+#endif /* TimeManager_hpp */
@@ -0,0 +1,92 @@
+//
+//  TranspositionTable.hpp
+//  Othello
+//
+//  Fixed-size hash table of search results, keyed on canonical positions so
+//  the 8 symmetric forms of a position share one entry.
+//
+
+#ifndef TranspositionTable_hpp
+#define TranspositionTable_hpp
+
+#include <cstdint>
+#include <vector>
+#include "BitBoard.hpp"
+
+namespace othello {
+
+    /// How a stored score relates to the position's true minimax value.
+    enum class Bound : uint8_t {
+        NONE = 0,
+        EXACT,      // the score is the value
+        LOWER,      // the search failed high: value >= score
+        UPPER       // the search failed low: value <= score
+    };
+
+    /// One search result (16 bytes).
+    struct TTEntry {
+        /// Full key of the position, 0 marks an empty slot.
+        uint64_t key;
+        int32_t score;
+        /// Remaining depth the score was searched to.
+        uint8_t depth;
+        Bound bound;
+        /// Best move found, as a square of the canonical form (NO_MOVE if none).
+        uint8_t move;
+        uint8_t padding;
+
+        static const uint8_t NO_MOVE = 0xFF;
+    };
+
+    class TranspositionTable {
+    private:
+        std::vector<TTEntry> entries_;
+        /// entries_.size() - 1 (the size is a power of 2).
+        uint64_t mask_;
+
+    public:
+        /// Creates an empty table.
+        /// @param sizeLog2 The table holds 2^sizeLog2 entries.
+        TranspositionTable(unsigned int sizeLog2);
+
+        //disabled constructors & operators
+        TranspositionTable() = delete;
+        TranspositionTable(const TranspositionTable& obj) = delete;   // copy
+        TranspositionTable(TranspositionTable&& obj) = delete;        // move
+        TranspositionTable& operator = (const TranspositionTable& obj) = delete;    // copy operator
+        TranspositionTable& operator = (TranspositionTable&& obj) = delete;        // move operator
+
+        /// Builds the key of a position as seen by a search. The score of a position depends on whose
+        /// turn it is and on whose point of view it's evaluated from, so both are folded into the key.
+        /// @param pos The position.
+        /// @param blackToMove Whether black is the player to move.
+        /// @param blackPerspective Whether scores are from black's point of view.
+        /// @param used Set to the symmetry that maps pos to its canonical form (for mapping moves).
+        static uint64_t key(const BitBoard& pos, bool blackToMove, bool blackPerspective, Symmetry& used);
+
+        /// Looks a position up.
+        /// @param key The position's key.
+        /// @param entry Set to the stored result if there is one.
+        /// @return Whether the position was found.
+        bool probe(uint64_t key, TTEntry& entry) const;
+
+        /// Stores a search result. A result for the same position only replaces a shallower one;
+        /// any other position in the slot is always replaced.
+        void store(uint64_t key, unsigned int depth, Bound bound, int score, int canonicalMove);
+
+        /// Empties the table.
+        void clear();
+
+        /// All the slots, empty ones included (key 0).
+        inline const std::vector<TTEntry>& getEntries() const {
+            return entries_;
+        }
+
+        /// Number of slots in the table.
+        inline size_t size() const {
+            return entries_.size();
+        }
+    };
+}
+
+#endif /* TranspositionTable_hpp */
@@ -0,0 +1,128 @@
+//
+//  VertexGrid.h
+//  Othello
+//
+//  Storage for a rows x columns grid of vertices (terrain, quad meshes...):
+//  positions and normals each in one contiguous, cache-line aligned block,
+//  row after row, 3 floats per vertex.
+//
+
+#ifndef VERTEX_GRID_H
+#define VERTEX_GRID_H
+
+#include <memory>
+#include "glPlatform.h"
+
+namespace graphics3d
+{
+    class VertexGrid
+    {
+        private:
+        
+            /// Releases a block obtained from the aligned operator new.
+            struct AlignedDelete_
+            {
+                void operator()(GLfloat* block) const;
+            };
+        
+            unsigned int numRows_;
+            unsigned int numCols_;
+            std::unique_ptr<GLfloat[], AlignedDelete_> xyz_;
+            std::unique_ptr<GLfloat[], AlignedDelete_> normals_;
+        
+            static std::unique_ptr<GLfloat[], AlignedDelete_> allocate_(size_t numFloats);
+        
+        public:
+        
+            /// Alignment of the two blocks, in bytes (a cache line).
+            static const size_t ALIGNMENT;
+            /// Floats per vertex, in both blocks.
+            static const unsigned int COMPONENTS = 3;
+        
+            /// Creates a grid with every position and normal at 0.
+            VertexGrid(unsigned int numRows, unsigned int numCols);
+        
+            //disabled constructors & operators
+            VertexGrid(const VertexGrid& obj) = delete;
+            VertexGrid& operator =(const VertexGrid& obj) = delete;
+            VertexGrid(VertexGrid&& obj) = delete;
+            VertexGrid& operator =(VertexGrid&& obj) = delete;
+            VertexGrid() = delete;
+        
+            inline unsigned int numRows() const
+            {
+                return numRows_;
+            }
+        
+            inline unsigned int numCols() const
+            {
+                return numCols_;
+            }
+        
+            inline unsigned int numVertices() const
+            {
+                return numRows_ * numCols_;
+            }
+        
+            /// Position of vertex (row, col) in the whole-grid arrays (row-major).
+            inline unsigned int index(unsigned int row, unsigned int col) const
+            {
+                return row * numCols_ + col;
+            }
+        
+            /// Floats from one row to the next in either block (vertex (row+1, col) is rowStride() after (row, col)).
+            inline unsigned int rowStride() const
+            {
+                return COMPONENTS * numCols_;
+            }
+        
+            /// The first vertex of a row; the others follow, COMPONENTS floats apart.
+            inline GLfloat* positionRow(unsigned int row)
+            {
+                return xyz_.get() + row * rowStride();
+            }
+            inline const GLfloat* positionRow(unsigned int row) const
+            {
+                return xyz_.get() + row * rowStride();
+            }
+            inline GLfloat* normalRow(unsigned int row)
+            {
+                return normals_.get() + row * rowStride();
+            }
+            inline const GLfloat* normalRow(unsigned int row) const
+            {
+                return normals_.get() + row * rowStride();
+            }
+        
+            /// {x, y, z} of vertex (row, col).
+            inline GLfloat* position(unsigned int row, unsigned int col)
+            {
+                return positionRow(row) + COMPONENTS * col;
+            }
+            inline const GLfloat* position(unsigned int row, unsigned int col) const
+            {
+                return positionRow(row) + COMPONENTS * col;
+            }
+            inline GLfloat* normal(unsigned int row, unsigned int col)
+            {
+                return normalRow(row) + COMPONENTS * col;
+            }
+            inline const GLfloat* normal(unsigned int row, unsigned int col) const
+            {
+                return normalRow(row) + COMPONENTS * col;
+            }
+        
+            /// The whole position block, ready to hand to GL as a vertex array.
+            inline const GLfloat* positions() const
+            {
+                return xyz_.get();
+            }
+        
+            inline const GLfloat* normals() const
+            {
+                return normals_.get();
+            }
+    };
+}
+
+#endif //    VERTEX_GRID_H
@@ -38,6 +38,31 @@ void setCurrentMaterial(GLfloat ambRed, GLfloat ambGreen, GLfloat ambBlue, GLflo
     GLfloat specBlue, GLfloat shine);
 void setCurrentMaterial(const Material& mat);
 
+//    The state cache: the functions above & below remember what they last set,
+//    and skip the GL calls when asked to set it again
+//
+struct RenderStateStats
+{
+    unsigned int materialChanges;
+    unsigned int materialsSkipped;
+    unsigned int shadeModelChanges;
+    unsigned int lightingChanges;
+    unsigned int callsSkipped;
+};
+
+void setShadeModel(GLenum model);
+void setLighting(bool enabled);
+//    Call after changing the material, shade model or lighting with direct GL calls
+void invalidateRenderState(void);
+//    What the cache did since the last reset (e.g. reset at the start of each frame)
+const RenderStateStats& renderStateStats(void);
+void resetRenderStateStats(void);
+
+//    Small number identifying a material (equal materials get the same one, starting at 1)
+unsigned int materialId(const Material& mat);
+//    Whether a material's diffuse alpha lets what's behind show through
+bool isTransparent(const Material& mat);
+
 //void saveAndSetMaterial(Material& currentMat, const Material& newMat);
 
 void updateRenderingMode(RenderingMode renderingMode);
@@ -0,0 +1,86 @@
+//
+//  glExtensions.h
+//  Othello
+//
+//  Run-time loading of the OpenGL entry points past 1.1 (shaders, instancing,
+//  buffers), so the renderer can use them where the context has them and
+//  fall back to the fixed pipeline where it doesn't.
+//
+
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <cstddef>
+#include "glPlatform.h"
+
+#ifndef APIENTRY
+    #define APIENTRY
+#endif
+
+//  Enums missing from the 1.1 headers some platforms ship
+#ifndef GL_VERTEX_SHADER
+    #define GL_FRAGMENT_SHADER      0x8B30
+    #define GL_VERTEX_SHADER        0x8B31
+    #define GL_COMPILE_STATUS       0x8B81
+    #define GL_LINK_STATUS          0x8B82
+    #define GL_INFO_LOG_LENGTH      0x8B84
+#endif
+#ifndef GL_ARRAY_BUFFER
+    #define GL_ARRAY_BUFFER         0x8892
+    #define GL_ELEMENT_ARRAY_BUFFER 0x8893
+    #define GL_STATIC_DRAW          0x88E4
+    #define GL_DYNAMIC_DRAW         0x88E8
+#endif
+
+namespace graphics3d
+{
+    //  Not in the 1.1 headers either
+    typedef std::ptrdiff_t GLsizeiptrType;
+    typedef std::ptrdiff_t GLintptrType;
+
+    struct GLExtensions
+    {
+        //    GL 1.5 buffer objects
+        void (APIENTRY *genBuffers)(GLsizei n, GLuint* buffers);
+        void (APIENTRY *deleteBuffers)(GLsizei n, const GLuint* buffers);
+        void (APIENTRY *bindBuffer)(GLenum target, GLuint buffer);
+        void (APIENTRY *bufferData)(GLenum target, GLsizeiptrType size, const void* data, GLenum usage);
+        void (APIENTRY *bufferSubData)(GLenum target, GLintptrType offset, GLsizeiptrType size, const void* data);
+        
+        //    GL 2.0 shaders
+        GLuint (APIENTRY *createShader)(GLenum type);
+        void (APIENTRY *shaderSource)(GLuint shader, GLsizei count, const char* const* string, const GLint* length);
+        void (APIENTRY *compileShader)(GLuint shader);
+        void (APIENTRY *getShaderiv)(GLuint shader, GLenum pname, GLint* params);
+        void (APIENTRY *getShaderInfoLog)(GLuint shader, GLsizei bufSize, GLsizei* length, char* infoLog);
+        void (APIENTRY *deleteShader)(GLuint shader);
+        GLuint (APIENTRY *createProgram)();
+        void (APIENTRY *attachShader)(GLuint program, GLuint shader);
+        void (APIENTRY *bindAttribLocation)(GLuint program, GLuint index, const char* name);
+        void (APIENTRY *linkProgram)(GLuint program);
+        void (APIENTRY *getProgramiv)(GLuint program, GLenum pname, GLint* params);
+        void (APIENTRY *getProgramInfoLog)(GLuint program, GLsizei bufSize, GLsizei* length, char* infoLog);
+        void (APIENTRY *useProgram)(GLuint program);
+        void (APIENTRY *enableVertexAttribArray)(GLuint index);
+        void (APIENTRY *disableVertexAttribArray)(GLuint index);
+        void (APIENTRY *vertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+        
+        //    GL_ARB_instanced_arrays
+        void (APIENTRY *vertexAttribDivisor)(GLuint index, GLuint divisor);
+        void (APIENTRY *drawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei primcount);
+        
+        /// Whether all the entry points of a group were found.
+        bool hasBuffers;
+        bool hasShaders;
+        bool hasInstancing;
+        
+        /// The entry points of the current context, looked up on the first call
+        /// (so it must only be called once a context exists, e.g. from a draw function).
+        static const GLExtensions& get();
+        
+        /// Whether the context advertises an extension (e.g. "GL_ARB_instanced_arrays").
+        static bool isSupported(const char* extension);
+    };
+}
+
+#endif //    GL_EXTENSIONS_H
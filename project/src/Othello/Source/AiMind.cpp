@@ -6,6 +6,7 @@
 //
 
 #include "AiMind.hpp"
+#include <algorithm>
 #include <iostream>
 
 
@@ -15,6 +16,9 @@ using namespace othello;
 RGBColor AiMind::WHITE = RGBColor{1, 1, 1};
 RGBColor AiMind::BLACK = RGBColor{0, 0, 0};
 
+const AiWeights AiMind::DEFAULT_WEIGHTS = AiWeights{1, 4, 6, 25, -8, -2};
+const unsigned int AiMind::TABLE_SIZE_LOG2_ = 18;
+
 
 AiMind::AiMind(unsigned int discWeight, unsigned int mobilityWeight, unsigned int stabilityWeight, unsigned int cornerWeight, int cornerAdjWeight, int frontierWeight, RGBColor defaultTileCol)
     :
@@ -24,123 +28,211 @@ AiMind::AiMind(unsigned int discWeight, unsigned int mobilityWeight, unsigned in
     CORNER_ADJ_WEIGHT_(cornerAdjWeight),
     NUM_FRONTIER_WEIGHT_(frontierWeight),
     NUM_DISC_WEIGHT_(discWeight),
-    DEFAULT_TILE_COLOR_(defaultTileCol)
+    DEFAULT_TILE_COLOR_(defaultTileCol),
+    table_(make_shared<TranspositionTable>(TABLE_SIZE_LOG2_)),
+    limits_(nullptr),
+    nodes_(0),
+    aborted_(false)
 {
     
 }
 
-
-int AiMind::minimax(bool maximizing, unsigned int depth, shared_ptr<Player>& playerBlack, shared_ptr<Player>& playerWhite, shared_ptr<Board>& thisBoard, shared_ptr<GameState>& layout, int alpha, int beta) {
-    if (depth == 0) //or game is over // base case
-        return evalGamestateScore(playerBlack, layout);
+AiMind::AiMind(const AiWeights& weights, RGBColor defaultTileCol)
+    :   AiMind(weights.discWeight, weights.mobilityWeight, weights.stabilityWeight, weights.cornerWeight, weights.cornerAdjWeight, weights.frontierWeight, defaultTileCol)
+{
     
-    std::vector<std::shared_ptr<Tile>> possibleMoves;
+}
+
+
+int AiMind::minimax(const BitBoard& pos, bool maximizing, unsigned int depth, bool aiIsBlack, int alpha, int beta, vector<int>* pv) {
+    SearchArena& arena = SearchArena::local();
+    int value = minimax_(pos, maximizing, depth, aiIsBlack, alpha, beta, 0, arena);
+    if (pv) {
+        PlyScratch& root = arena.ply(0);
+        pv->assign(root.pv, root.pv + root.pvLength);
+    }
+    return value;
+}
+
+
+int AiMind::minimax_(const BitBoard& pos, bool maximizing, unsigned int depth, bool aiIsBlack, int alpha, int beta, unsigned int ply, SearchArena& arena) {
+    PlyScratch& scratch = arena.ply(ply);
+    scratch.pvLength = 0;
+    if (searchAborted_()) // the interrupted iteration gets thrown away, so the value doesn't matter
+        return 0;
     
-    if (maximizing) {
-        // simulate black placing a piece that puts them at the largest advantage
-        layout->getPlayableTiles(playerBlack, possibleMoves);
-        if (possibleMoves.size() == 0) { // no more moves for black
-            std::cout << "no more moves in this branch(black)\n";
-            return evalGamestateScore(playerBlack, layout);
-        }
-        int maxEval = INT_MIN;
-        for (unsigned int i = 0; i < possibleMoves.size(); i++) {
-            shared_ptr<Tile> thisMove = possibleMoves[i];
-            int eval = applyMinimaxMove_(maximizing, depth, thisMove, thisBoard, alpha, beta);
-            maxEval = std::max(maxEval, eval);
-            alpha = std::max(alpha, eval);
-            if (beta <= alpha) {
-                break; // alpha-beta pruning
+    // look the position up: a deep enough result answers this node outright, and otherwise its move is tried first
+    bool blackToMove = (maximizing == aiIsBlack);
+    Symmetry sym;
+    uint64_t key = TranspositionTable::key(pos, blackToMove, aiIsBlack, sym);
+    int hashMove = -1;
+    TTEntry entry;
+    bool found = table_->probe(key, entry);
+    if (!found && cache_ && cache_->probe(key, entry)) {
+        // copy it into the first level, so the next probe doesn't have to search the file
+        table_->store(key, entry.depth, entry.bound, entry.score, (entry.move == TTEntry::NO_MOVE) ? -1 : entry.move);
+        found = true;
+    }
+    if (found) {
+        if (entry.move != TTEntry::NO_MOVE)
+            hashMove = BitBoard::transformSquare(entry.move, BitBoard::inverse(sym));
+        if ((entry.depth >= depth) &&
+            ((entry.bound == Bound::EXACT) ||
+             ((entry.bound == Bound::LOWER) && (entry.score >= beta)) ||
+             ((entry.bound == Bound::UPPER) && (entry.score <= alpha)))) {
+            if (hashMove >= 0) {
+                scratch.pv[0] = hashMove;
+                scratch.pvLength = 1;
             }
+            return entry.score;
         }
-        return maxEval;
-    } else {
-        // simulate white placing the piece which puts black at the largest disadvantage
-        layout->getPlayableTiles(playerWhite, possibleMoves);
-        if (possibleMoves.size() == 0) { // no more moves for white
-            std::cout << "no more moves in this branch(white)\n";
-            return evalGamestateScore(playerBlack, layout);
+    }
+    
+    if (depth == 0) { //or game is over // base case
+        int eval = evalPosition(pos, aiIsBlack);
+        table_->store(key, 0, Bound::EXACT, eval, -1);
+        return eval;
+    }
+    
+    // maximizing: simulate the AI placing a piece that puts them at the largest advantage
+    // minimizing: simulate the opponent placing the piece which puts the AI at the largest disadvantage
+    uint64_t legal = pos.legalMoves(blackToMove);
+    if (legal == 0) { // no more moves for this side
+        int value = evalPosition(pos, aiIsBlack);
+        table_->store(key, depth, Bound::EXACT, value, -1);
+        return value;
+    }
+    scratch.numMoves = 0;
+    if ((hashMove >= 0) && (legal & (1ULL << hashMove))) {
+        scratch.moves[scratch.numMoves++] = hashMove;
+        legal &= ~(1ULL << hashMove);
+    }
+    for (; legal; legal &= legal - 1)
+        scratch.moves[scratch.numMoves++] = BitBoard::lowestSquare(legal);
+    
+    const int alphaOrig = alpha, betaOrig = beta;
+    int bestSq = -1;
+    int value = maximizing ? INT_MIN : INT_MAX;
+    for (int i = 0; i < scratch.numMoves; i++) {
+        BitBoard child = pos;
+        child.play(scratch.moves[i], blackToMove);
+        int eval = minimax_(child, !maximizing, depth - 1, aiIsBlack, alpha, beta, ply + 1, arena);
+        if (maximizing ? (eval > value) : (eval < value)) {
+            value = eval;
+            bestSq = scratch.moves[i];
+            arena.updatePv(ply, bestSq);
         }
-        int minEval = INT_MAX;
-        for (unsigned int i = 0; i < possibleMoves.size(); i++) {
-            shared_ptr<Tile> thisMove = possibleMoves[i];
-            int eval = applyMinimaxMove_(maximizing, depth, thisMove, thisBoard, alpha, beta);
-            minEval = std::min(minEval, eval);
+        if (maximizing)
+            alpha = std::max(alpha, eval);
+        else
             beta = std::min(beta, eval);
-            if (beta <= alpha) {
-                break; // alpha-beta pruning
-            }
+        if (beta <= alpha) {
+            break; // alpha-beta pruning
         }
-        return minEval;
     }
+    
+    if (!aborted_) {
+        Bound bound = (value <= alphaOrig) ? Bound::UPPER : ((value >= betaOrig) ? Bound::LOWER : Bound::EXACT);
+        table_->store(key, depth, bound, value, (bestSq >= 0) ? BitBoard::transformSquare(bestSq, sym) : -1);
+    }
+    return value;
+}
+
+
+int AiMind::evalMove_(const BitBoard& pos, bool aiIsBlack, int sq, unsigned int depth, vector<int>* pv, int alpha) {
+    BitBoard child = pos;
+    child.play(sq, aiIsBlack);
+    SearchArena& arena = SearchArena::local();
+    int score = minimax_(child, false, depth, aiIsBlack, alpha, INT_MAX, 1, arena);
+    if (pv) {
+        arena.updatePv(0, sq);
+        PlyScratch& root = arena.ply(0);
+        pv->assign(root.pv, root.pv + root.pvLength);
+    }
+    return score;
 }
 
-int AiMind::applyMinimaxMove_(bool maxing, unsigned int depth, shared_ptr<Tile>& thisMove, shared_ptr<Board>& oldBoard, int alpha, int beta) {
-    // each hypothetical move needs a new board object, thus also needs a new gamestate obj and new player objs
-    shared_ptr<Player> tempWhite = make_shared<Player>(WHITE, "white");
-    shared_ptr<Player> tempBlack = make_shared<Player>(BLACK, "black");
-    shared_ptr<Player> tempNull = make_shared<Player>(RGBColor{-1, -1, -1}, "null");
-    shared_ptr<Board> tempBoard = make_shared<Board>(DEFAULT_TILE_COLOR_, tempNull);
-    shared_ptr<GameState> tempGamestate = make_shared<GameState>(tempWhite, tempBlack, tempBoard);
-    shared_ptr<Player> tempOwner;
-    // bring the new board up to date
-    // oldboard = the board before this hypothetical move
-    for (shared_ptr<Disc> piece : oldBoard->getAllPieces()) {
-        TilePoint thisPiecePos = piece->getPos();
-        if (piece->getColor().isEqualTo(WHITE)) {
-            tempOwner = tempWhite;
-        } else {
-            tempOwner = tempBlack;
+
+BitBoard AiMind::boardPosition_(shared_ptr<Board>& board) {
+    // read the tile owners rather than the disc colors: a flipped disc only changes
+    // color once its flip animation has played, but its tile changes owner right away
+    BitBoard pos{0, 0};
+    vector<vector<shared_ptr<Tile>>>* boardTiles = board->getBoardTiles();
+    for (unsigned int r = 0; r < boardTiles->size(); r++) {
+        for (shared_ptr<Tile> tile : boardTiles->at(r)) {
+            RGBColor ownerColor = tile->getPieceOwner()->getMyColor();
+            uint64_t bit = 1ULL << BitBoard::squareIndex(tile->getPos());
+            if (ownerColor.isEqualTo(BLACK))
+                pos.black |= bit;
+            else if (ownerColor.isEqualTo(WHITE))
+                pos.white |= bit;
         }
-        tempGamestate->addGamePiece(thisPiecePos, tempOwner);
     }
-    TilePoint thisMoveLoc = thisMove->getPos();
-    shared_ptr<Tile> hypMove = tempBoard->getBoardTile(thisMoveLoc);
-    
-    // the maximizing player (AI) is black
-    if (maxing) {
-        tempOwner = tempBlack;
-    } else {
-        tempOwner = tempWhite;
+    return pos;
+}
+
+
+bool AiMind::searchAborted_() {
+    nodes_++;
+    if (limits_ == nullptr)
+        return false;
+    if (aborted_)
+        return true;
+    if ((limits_->maxNodes > 0) && (nodes_ >= limits_->maxNodes))
+        aborted_ = true;
+    else if ((limits_->stopFlag != nullptr) && limits_->stopFlag->load())
+        aborted_ = true;
+    else if ((limits_->maxSeconds > 0) &&
+             (chrono::duration<double>(chrono::steady_clock::now() - searchStart_).count() >= limits_->maxSeconds))
+        aborted_ = true;
+    return aborted_;
+}
+
+
+uint64_t AiMind::evalFingerprint() const {
+    // the first value is the version of the evaluation itself (2 = computed on bitboards)
+    const int weights[] = {2, (int)NUM_DISC_WEIGHT_, (int)MOBILITY_WEIGHT_, (int)STABILITY_WEIGHT_, (int)CORNER_WEIGHT_, CORNER_ADJ_WEIGHT_, NUM_FRONTIER_WEIGHT_};
+    uint64_t fingerprint = 0xCBF29CE484222325ULL; // FNV-1a
+    for (int w : weights) {
+        fingerprint ^= (uint32_t)w;
+        fingerprint *= 0x100000001B3ULL;
     }
-    tempGamestate->placePiece(tempOwner, hypMove);
-    
-    return minimax(!maxing, depth - 1, tempBlack, tempWhite, tempBoard, tempGamestate, alpha, beta);
+    return fingerprint;
 }
 
 
 int AiMind::evalGamestateScore(shared_ptr<Player>& forWho, shared_ptr<GameState>& layout) {
-    unsigned int numDiscs, mobility, stability, cornerPieces, cornerAdj, frontiers;
+    return evalPosition(layout->toBitBoard(), forWho->getMyColor().isEqualTo(BLACK));
+}
+
+
+int AiMind::evalPosition(const BitBoard& pos, bool forBlack) const {
+    const uint64_t CORNERS = 0x8100000000000081ULL;
+    uint64_t mine = forBlack ? pos.black : pos.white;
+    uint64_t theirs = forBlack ? pos.white : pos.black;
+    uint64_t empty = pos.empties();
     GamestateScore curScore;
     
-    /// Find number of discs I control
-    std::vector<std::vector<std::shared_ptr<Tile>>> myTiles;
-    numDiscs = layout->getPlayerTiles(forWho, myTiles);
-    
-    /// Find my mobility (number of possible moves)
-    std::vector<std::shared_ptr<Tile>> possibleMoves;
-    layout->getPlayableTiles(forWho, possibleMoves);
-    mobility = (int)possibleMoves.size();
-    
-    /// Calculate stability and count corner pieces
-    std::vector<std::vector<std::shared_ptr<Tile>>> allMyPieces;  // tiles where I currently have pieces placed
-    layout->getPlayerTiles(forWho, allMyPieces); // populate my tiles
-    cornerPieces = 0;
-    cornerAdj = 0;
-    stability = 0;
-    frontiers = 0;
-    for (unsigned int r = 0; r < allMyPieces.size(); r++) {
-        for (unsigned int c = 0; c < allMyPieces[r].size(); c++) {
-            std::shared_ptr<Tile> thisTile = allMyPieces[r][c];
-            if (layout->isCornerTile(thisTile)) // if the tile is a corner piece
-                cornerPieces++;
-            if (layout->isCornerAdj(thisTile))
-                cornerAdj++;
-            if (layout->discIsStable(thisTile)) // if the tile isn't flankable by the opponent
-                stability++;
-            frontiers += layout->numFrontierTiles(thisTile);
-        }
+    /// Find number of discs I control, and my mobility (number of possible moves)
+    unsigned int numDiscs = BitBoard::popCount(mine);
+    unsigned int mobility = BitBoard::popCount(BitBoard::legalMoves(mine, theirs));
+    
+    /// A disc is stable if none of the squares around it would flank anything for the opponent
+    uint64_t flankFrom = 0;
+    for (uint64_t around = BitBoard::neighbors(mine); around; around &= around - 1) {
+        int sq = BitBoard::lowestSquare(around);
+        if (BitBoard::flips(sq, theirs, mine) != 0)
+            flankFrom |= 1ULL << sq;
     }
+    unsigned int stability = BitBoard::popCount(mine & ~BitBoard::neighbors(flankFrom));
+    
+    /// Count corner pieces, pieces next to corners and the blank tiles next to my pieces
+    unsigned int cornerPieces = BitBoard::popCount(mine & CORNERS);
+    unsigned int cornerAdj = BitBoard::popCount(mine & BitBoard::neighbors(CORNERS));
+    unsigned int frontiers = 0;
+    for (int d = 0; d < BitBoard::NUM_DIRECTIONS; d++)
+        frontiers += BitBoard::popCount(BitBoard::shift(mine, d) & empty);
+    
     /// Multiply by weights and sum products together
     curScore.mobilityScore = mobility * MOBILITY_WEIGHT_;
     curScore.cornerControlScore = cornerPieces * CORNER_WEIGHT_;
@@ -158,37 +250,8 @@ unsigned int AiMind::bestMoveMinimax(shared_ptr<Player>& aiPlayer, shared_ptr<Bo
     int bestMoveScore = 0;
     int curMoveScore = 0;
     for (unsigned int i = 0; i < possibleMoves.size(); i++) {
-        shared_ptr<Tile> thisMove = possibleMoves[i];
-        
-        shared_ptr<Player> tempWhite = make_shared<Player>(WHITE, "white");
-        shared_ptr<Player> tempBlack = make_shared<Player>(BLACK, "black");
-        shared_ptr<Player> tempNull = make_shared<Player>(RGBColor{-1, -1, -1}, "null");
-        shared_ptr<Board> tempBoard = make_shared<Board>(DEFAULT_TILE_COLOR_, tempNull);
-        shared_ptr<GameState> tempGamestate = make_shared<GameState>(tempWhite, tempBlack, tempBoard);
-        shared_ptr<Player> tempOwner;
-        // bring the new board up to date
-        // thisboard = the board before this hypothetical move
-        for (shared_ptr<Disc> piece : mainGameBoard->getAllPieces()) {
-            TilePoint thisPiecePos = piece->getPos();
-            if (piece->getColor().isEqualTo(WHITE)) {
-                tempOwner = tempWhite;
-            } else {
-                tempOwner = tempBlack;
-            }
-            tempGamestate->addGamePiece(thisPiecePos, tempOwner);
-        }
-        TilePoint thisMoveLoc = thisMove->getPos();
-        shared_ptr<Tile> hypMove = tempBoard->getBoardTile(thisMoveLoc);
-        tempGamestate->placePiece(tempBlack, hypMove);
-        
         // applying minimax to this hypothetical move will give us the overall score for this move
-        if (aiPlayer->getMyColor().isEqualTo(BLACK)) {
-            // AI is in black's perspective, white is the opponent
-            curMoveScore = minimax(false, depth, tempBlack, tempWhite, tempBoard, tempGamestate, INT_MIN, INT_MAX);
-        } else {
-            // AI is in white's perspective, black is the opponent
-            curMoveScore = minimax(false, depth, tempWhite, tempBlack, tempBoard, tempGamestate, INT_MIN, INT_MAX);
-        }
+        curMoveScore = evalMoveMinimax(aiPlayer, mainGameBoard, possibleMoves[i], depth);
         if (curMoveScore > bestMoveScore) {
             bestMoveInd = i;
             bestMoveScore = curMoveScore;
@@ -197,3 +260,171 @@ unsigned int AiMind::bestMoveMinimax(shared_ptr<Player>& aiPlayer, shared_ptr<Bo
     }
     return bestMoveInd;
 }
+
+
+int AiMind::evalMoveMinimax(shared_ptr<Player>& aiPlayer, shared_ptr<Board>& mainGameBoard, shared_ptr<Tile>& move, unsigned int depth, vector<int>* pv, int alpha) {
+    // mainGameBoard = the board before this hypothetical move
+    return evalMove_(boardPosition_(mainGameBoard), aiPlayer->getMyColor().isEqualTo(BLACK), BitBoard::squareIndex(move->getPos()), depth, pv, alpha);
+}
+
+
+vector<int> AiMind::scoreMovesMinimax(const BitBoard& pos, bool blackToMove, vector<int>& moves, unsigned int depth) {
+    vector<int> scores;
+    moves.clear();
+    uint64_t legal = pos.legalMoves(blackToMove);
+    while (legal) {
+        int sq = BitBoard::lowestSquare(legal);
+        legal &= legal - 1;
+        moves.push_back(sq);
+        scores.push_back(evalMove_(pos, blackToMove, sq, depth, nullptr, INT_MIN));
+    }
+    return scores;
+}
+
+
+SearchInfo AiMind::searchIterative(const BitBoard& pos, bool blackToMove, const SearchLimits& limits, const function<bool(const SearchInfo&)>& onIteration) {
+    searchStart_ = chrono::steady_clock::now();
+    limits_ = &limits;
+    nodes_ = 0;
+    aborted_ = false;
+    
+    SearchInfo best{0, -1, 0, INT_MIN, {}, 0, 0.0};
+    uint64_t legal = pos.legalMoves(blackToMove);
+    if (legal == 0) {
+        limits_ = nullptr;
+        aborted_ = false;
+        return best;
+    }
+    
+    vector<int> rootMoves;
+    while (legal) {
+        rootMoves.push_back(BitBoard::lowestSquare(legal));
+        legal &= legal - 1;
+    }
+    // until an iteration completes, the first legal move is all we have
+    best.bestMove = rootMoves[0];
+    best.pv.assign(1, rootMoves[0]);
+    
+    // searching past the last empty square can't find anything new
+    unsigned int maxDepth = (unsigned int)BitBoard::popCount(pos.empties());
+    if ((limits.maxDepth > 0) && (limits.maxDepth < maxDepth))
+        maxDepth = limits.maxDepth;
+    
+    vector<int> pv;
+    for (unsigned int depth = 1; depth <= maxDepth; depth++) {
+        SearchInfo iteration{depth, -1, INT_MIN, INT_MIN, {}, 0, 0.0};
+        for (int sq : rootMoves) {
+            int score = evalMove_(pos, blackToMove, sq, depth - 1, &pv, INT_MIN);
+            if (aborted_)
+                break;
+            if (score > iteration.score) {
+                iteration.runnerUpScore = iteration.score;
+                iteration.bestMove = sq;
+                iteration.score = score;
+                iteration.pv = pv;
+            } else if (score > iteration.runnerUpScore) {
+                iteration.runnerUpScore = score;
+            }
+        }
+        if (aborted_)
+            break;
+        
+        iteration.nodes = nodes_;
+        iteration.seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart_).count();
+        best = iteration;
+        // try the previous best move first in the next iteration
+        rootMoves.erase(find(rootMoves.begin(), rootMoves.end(), best.bestMove));
+        rootMoves.insert(rootMoves.begin(), best.bestMove);
+        if (!onIteration(best))
+            break;
+    }
+    best.nodes = nodes_;
+    best.seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart_).count();
+    limits_ = nullptr;
+    aborted_ = false;
+    return best;
+}
+
+
+MultiPvInfo AiMind::searchMultiPv(const BitBoard& pos, bool blackToMove, unsigned int numLines, const SearchLimits& limits, const function<bool(const MultiPvInfo&)>& onUpdate) {
+    searchStart_ = chrono::steady_clock::now();
+    limits_ = &limits;
+    nodes_ = 0;
+    aborted_ = false;
+    
+    vector<RootMoveInfo> rootMoves;
+    uint64_t legal = pos.legalMoves(blackToMove);
+    while (legal) {
+        int sq = BitBoard::lowestSquare(legal);
+        rootMoves.push_back(RootMoveInfo{sq, 0, INT_MIN, false, {sq}});
+        legal &= legal - 1;
+    }
+    unsigned int numMoves = (unsigned int)rootMoves.size();
+    if ((numLines == 0) || (numLines > numMoves))
+        numLines = numMoves;
+    
+    // lines with exact scores first, then by score
+    auto byScore = [](const RootMoveInfo& a, const RootMoveInfo& b) {
+        if (a.exact != b.exact)
+            return a.exact;
+        return a.score > b.score;
+    };
+    auto report = [&](unsigned int depth, unsigned int movesSearched, vector<RootMoveInfo> lines) {
+        stable_sort(lines.begin(), lines.end(), byScore);
+        lines.resize(numLines);
+        MultiPvInfo info{depth, movesSearched, numMoves, lines, nodes_,
+                         chrono::duration<double>(chrono::steady_clock::now() - searchStart_).count()};
+        return info;
+    };
+    MultiPvInfo best = report(0, numMoves, rootMoves);
+    if (numMoves == 0) {
+        limits_ = nullptr;
+        aborted_ = false;
+        return best;
+    }
+    
+    unsigned int maxDepth = (unsigned int)BitBoard::popCount(pos.empties());
+    if ((limits.maxDepth > 0) && (limits.maxDepth < maxDepth))
+        maxDepth = limits.maxDepth;
+    
+    vector<int> pv;
+    bool stopped = false;
+    for (unsigned int depth = 1; (depth <= maxDepth) && !stopped; depth++) {
+        // search in the previous iteration's order, so the top lines are found early and narrow the window for the rest
+        vector<RootMoveInfo> iteration = rootMoves;
+        vector<int> topScores;  // exact scores found so far this iteration, best first
+        for (unsigned int i = 0; i < numMoves; i++) {
+            // once numLines moves have exact scores, the others only need to be proven worse than the last of them
+            int alpha = (topScores.size() >= numLines) ? topScores[numLines - 1] : INT_MIN;
+            int score = evalMove_(pos, blackToMove, iteration[i].move, depth - 1, &pv, alpha);
+            if (aborted_)
+                break;
+            
+            RootMoveInfo& line = iteration[i];
+            line.depth = depth;
+            line.score = score;
+            line.exact = (score > alpha);
+            line.pv = pv;
+            if (line.exact)
+                topScores.insert(upper_bound(topScores.begin(), topScores.end(), score, greater<int>()), score);
+            
+            if ((i + 1 < numMoves) && !onUpdate(report(depth, i + 1, iteration))) {
+                stopped = true;
+                break;
+            }
+        }
+        if (aborted_ || stopped)
+            break;
+        
+        stable_sort(iteration.begin(), iteration.end(), byScore);
+        rootMoves = iteration;
+        best = report(depth, numMoves, rootMoves);
+        if (!onUpdate(best))
+            break;
+    }
+    best.nodes = nodes_;
+    best.seconds = chrono::duration<double>(chrono::steady_clock::now() - searchStart_).count();
+    limits_ = nullptr;
+    aborted_ = false;
+    return best;
+}
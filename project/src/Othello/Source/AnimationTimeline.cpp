@@ -0,0 +1,84 @@
+//
+//  AnimationTimeline.cpp
+//  Othello
+//
+
+#include "AnimationTimeline.hpp"
+#include <algorithm>
+
+using namespace std;
+using namespace othello;
+
+
+AnimationTimeline::AnimationTimeline()
+    :   now_(0.0),
+        nextOrder_(0),
+        nextSequence_(1)
+{
+
+}
+
+
+uint32_t AnimationTimeline::beginSequence() {
+    uint32_t sequence = nextSequence_++;
+    if (nextSequence_ == 0) // 0 means "every sequence" to extract_
+        nextSequence_ = 1;
+    return sequence;
+}
+
+
+void AnimationTimeline::schedule(uint32_t sequence, float delay, const Action& action) {
+    events_.push_back(Event_{now_ + max(delay, 0.f), nextOrder_++, sequence, action});
+    push_heap(events_.begin(), events_.end(), FiresLater_());
+}
+
+
+void AnimationTimeline::advance(float dt) {
+    now_ += dt;
+    // an action may schedule new events, so the front is re-checked after each one fires
+    while (!events_.empty() && (events_.front().dueTime <= now_)) {
+        pop_heap(events_.begin(), events_.end(), FiresLater_());
+        Action action = std::move(events_.back().action);
+        events_.pop_back();
+        action();
+    }
+}
+
+
+vector<AnimationTimeline::Event_> AnimationTimeline::extract_(uint32_t sequence) {
+    vector<Event_> extracted;
+    auto kept = partition(events_.begin(), events_.end(), [sequence](const Event_& e) {
+        return (sequence != 0) && (e.sequence != sequence);
+    });
+    extracted.assign(make_move_iterator(kept), make_move_iterator(events_.end()));
+    events_.erase(kept, events_.end());
+    make_heap(events_.begin(), events_.end(), FiresLater_());
+    sort(extracted.begin(), extracted.end(), [](const Event_& a, const Event_& b) {
+        return FiresLater_()(b, a);
+    });
+    return extracted;
+}
+
+
+void AnimationTimeline::cancel(uint32_t sequence) {
+    extract_(sequence);
+}
+
+
+void AnimationTimeline::finish(uint32_t sequence) {
+    for (Event_& e : extract_(sequence))
+        e.action();
+}
+
+
+void AnimationTimeline::finishAll() {
+    for (Event_& e : extract_(0))
+        e.action();
+}
+
+
+bool AnimationTimeline::isPending(uint32_t sequence) const {
+    return any_of(events_.begin(), events_.end(), [sequence](const Event_& e) {
+        return e.sequence == sequence;
+    });
+}
@@ -0,0 +1,142 @@
+//
+//  BatchAnnotator.cpp
+//  Othello
+//
+
+#include "BatchAnnotator.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+using namespace othello;
+
+
+BatchAnnotator::BatchAnnotator(const GameDatabase& games, unsigned int depth, unsigned int numThreads, int blunderThreshold)
+    :   games_(games),
+        depth_(depth),
+        numThreads_(numThreads > 0 ? numThreads : max(1u, thread::hardware_concurrency())),
+        blunderThreshold_(blunderThreshold)
+{
+    
+}
+
+
+unsigned int BatchAnnotator::annotateGame_(AiMind& mind, size_t gameIndex, string& out, unsigned int& numBlunders) const {
+    const StoredGame& game = games_.at(gameIndex);
+    ostringstream lines;
+    BitBoard pos = BitBoard::initialPosition();
+    bool blackToMove = true;
+    unsigned int numPositions = 0;
+    vector<int> moves;
+    
+    for (int ply = 0; ply < game.numMoves; ply++) {
+        // the side to move passes if it has nothing to play
+        if (pos.legalMoves(blackToMove) == 0)
+            blackToMove = !blackToMove;
+        
+        int played = game.moves[ply];
+        vector<int> scores = mind.scoreMovesMinimax(pos, blackToMove, moves, depth_);
+        numPositions++;
+        
+        int bestInd = 0, playedInd = -1;
+        for (unsigned int i = 0; i < moves.size(); i++) {
+            if (scores[i] > scores[bestInd])
+                bestInd = i;
+            if (moves[i] == played)
+                playedInd = i;
+        }
+        if (playedInd < 0) // games are validated on import, so this shouldn't happen
+            break;
+        
+        int loss = scores[bestInd] - scores[playedInd];
+        bool blunder = loss >= blunderThreshold_;
+        if (blunder)
+            numBlunders++;
+        lines << gameIndex << '\t' << ply + 1 << '\t' << (blackToMove ? "black" : "white") << '\t'
+              << GameDatabase::squareName(played) << '\t' << scores[playedInd] << '\t'
+              << GameDatabase::squareName(moves[bestInd]) << '\t' << scores[bestInd] << '\t'
+              << loss << '\t' << (blunder ? 1 : 0) << '\n';
+        
+        GameDatabase::playMove(pos, blackToMove, played);
+    }
+    out = lines.str();
+    return numPositions;
+}
+
+
+size_t BatchAnnotator::run(const char* outputPath) {
+    ofstream output(outputPath);
+    if (!output.is_open()) {
+        cout << "BatchAnnotator ERROR: Unable to open output file " << outputPath << "\n";
+        return 0;
+    }
+    output << "game\tply\tcolor\tmove\tscore\tbest\tbest_score\tloss\tblunder\n";
+    
+    const size_t numGames = games_.size();
+    // each game's annotations are written in game order as soon as all earlier games are done;
+    // workers wait rather than start a game more than maxAhead games past the writer, so a slow
+    // early game can't let every later game's text pile up in results
+    const size_t maxAhead = 2 * (size_t) numThreads_;
+    vector<string> results(numGames);
+    vector<bool> finished(numGames, false);
+    mutex resultsLock;
+    condition_variable resultReady, writerAdvanced;
+    size_t nextGame = 0, numWritten = 0;
+    atomic<size_t> numPositions(0);
+    atomic<unsigned int> numBlunders(0);
+    
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (unsigned int t = 0; t < numThreads_; t++) {
+        workers.emplace_back([&]() {
+            AiMind mind(AiMind::DEFAULT_WEIGHTS, RGBColor{0.f, 0.f, 0.5f});
+            string annotations;
+            while (true) {
+                size_t gameIndex;
+                {
+                    unique_lock<mutex> lock(resultsLock);
+                    writerAdvanced.wait(lock, [&]() { return (nextGame >= numGames) || (nextGame < numWritten + maxAhead); });
+                    if (nextGame >= numGames)
+                        break;
+                    gameIndex = nextGame++;
+                }
+                unsigned int blunders = 0;
+                numPositions += annotateGame_(mind, gameIndex, annotations, blunders);
+                numBlunders += blunders;
+                {
+                    lock_guard<mutex> lock(resultsLock);
+                    results[gameIndex].swap(annotations);
+                    finished[gameIndex] = true;
+                }
+                resultReady.notify_one();
+            }
+        });
+    }
+    
+    for (size_t g = 0; g < numGames; g++) {
+        string annotations;
+        {
+            unique_lock<mutex> lock(resultsLock);
+            resultReady.wait(lock, [&]() { return finished[g]; });
+            annotations.swap(results[g]);
+            numWritten = g + 1;
+        }
+        writerAdvanced.notify_all();
+        output << annotations;
+    }
+    for (thread& worker : workers)
+        worker.join();
+    auto end = chrono::steady_clock::now();
+    
+    double secs = chrono::duration<double>(end - start).count();
+    cout << "Annotated " << numGames << " games, " << numPositions << " positions at depth " << depth_
+         << " on " << numThreads_ << " threads in " << secs << " s ("
+         << (secs > 0 ? numPositions / secs : 0) << " positions/sec), " << numBlunders << " blunders\n";
+    return numPositions;
+}
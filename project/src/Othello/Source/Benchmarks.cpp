@@ -0,0 +1,379 @@
+//
+//  Benchmarks.cpp
+//  Othello
+//
+
+#include "Benchmarks.hpp"
+#include "AiMind.hpp"
+#include "BitBoard.hpp"
+#include "SearchArena.hpp"
+#include "SessionManager.hpp"
+#include "BinaryMesh.h"
+#include "Cylinder3D.h"
+#include "Frustum.h"
+#include "InstancedMeshBatch.h"
+#include "LevelOfDetail.h"
+#include "MeshAssetCache.h"
+#include "ObjectBVH.h"
+#include "OffscreenContext.h"
+#include "QuadMesh3D.h"
+#include "RenderQueue.h"
+#include "SceneNode.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+using namespace othello;
+using namespace graphics3d;
+
+
+int othello::benchSymmetry(unsigned int numPositions, unsigned int numRounds) {
+    // random positions: each square is empty, black or white with equal odds
+    default_random_engine engine(406);
+    uniform_int_distribution<int> squareDist(0, 2);
+    vector<BitBoard> positions(numPositions);
+    for (BitBoard& pos : positions) {
+        pos = BitBoard{0, 0};
+        for (int sq = 0; sq < BitBoard::NUM_SQUARES; sq++) {
+            int state = squareDist(engine);
+            if (state == 1)
+                pos.black |= 1ULL << sq;
+            else if (state == 2)
+                pos.white |= 1ULL << sq;
+        }
+    }
+
+    // correctness: every symmetric form must share the canonical form, and the
+    // returned symmetry must map the position onto it
+    unsigned int failures = 0;
+    for (const BitBoard& pos : positions) {
+        Symmetry used;
+        BitBoard canon = pos.canonical(used);
+        if (pos.transformed(used) != canon)
+            failures++;
+        for (int s = 0; s < static_cast<int>(Symmetry::NB_SYMMETRIES); s++) {
+            Symmetry other;
+            if (pos.transformed(static_cast<Symmetry>(s)).canonical(other) != canon)
+                failures++;
+        }
+    }
+
+    // timing
+    uint64_t checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (unsigned int r = 0; r < numRounds; r++) {
+        for (const BitBoard& pos : positions) {
+            Symmetry used;
+            checksum += pos.canonicalHash(used) + static_cast<uint64_t>(used);
+        }
+    }
+    auto end = chrono::steady_clock::now();
+
+    double secs = chrono::duration<double>(end - start).count();
+    double calls = (double)numPositions * numRounds;
+    cout << "symmetry benchmark: " << numPositions << " positions x " << numRounds << " rounds\n";
+    cout << "  " << (secs * 1e9 / calls) << " ns per canonicalHash, "
+         << (calls / secs / 1e6) << " M positions/sec (checksum " << checksum << ")\n";
+    cout << "  symmetry check: " << (failures == 0 ? "ok" : "FAILED") << " (" << failures << " failures)\n";
+    return failures == 0 ? 0 : 1;
+}
+
+
+int othello::benchHosting(unsigned int numSessions, unsigned int numWorkers, unsigned int nodesPerMove) {
+    SessionManager manager(numWorkers);
+    atomic<unsigned int> gamesFinished(0);
+    SessionBudget budget{0, nodesPerMove, 0.0};
+
+    // one engine per game, seeded by the order the games were created in, so every run plays the same moves
+    // whichever worker thread each turn lands on (filled before the first turn, then only read)
+    unordered_map<uint32_t, default_random_engine> engines;
+
+    // the stand-in human plays random legal moves (until it's the AI's turn again or the game ends),
+    // then asks for the AI's reply; it runs again from the reply's callback, so every game keeps going
+    function<void(uint32_t, int)> humanTurn = [&](uint32_t sessionId, int) {
+        default_random_engine& engine = engines.at(sessionId);
+        BitBoard pos;
+        bool blackToMove;
+        while (manager.getPosition(sessionId, pos, blackToMove)) {
+            if (SessionManager::isGameOver(pos)) {
+                gamesFinished++;
+                return;
+            }
+            if (manager.requestAiMove(sessionId, humanTurn))
+                return;
+            uint64_t legal = pos.legalMoves(blackToMove);
+            int pick = uniform_int_distribution<int>(0, BitBoard::popCount(legal) - 1)(engine);
+            while (pick-- > 0)
+                legal &= legal - 1;
+            manager.playMove(sessionId, BitBoard::lowestSquare(legal));
+        }
+    };
+
+    vector<uint32_t> sessions;
+    for (unsigned int g = 0; g < numSessions; g++) {
+        sessions.push_back(manager.createSession(g % 2 == 0, budget));
+        engines.emplace(sessions.back(), default_random_engine(406 + g));
+    }
+    for (uint32_t sessionId : sessions)
+        humanTurn(sessionId, -1);
+    manager.waitIdle();
+
+    HostingReport stats = manager.report();
+    cout << "hosting benchmark: " << numSessions << " games, " << nodesPerMove << " nodes per AI move\n";
+    cout << "  " << stats.movesServed << " AI moves in " << stats.seconds << " s ("
+         << stats.movesPerSecond << " moves/sec)\n";
+    cout << "  latency ms: p50 " << stats.latencyP50 << ", p95 " << stats.latencyP95
+         << ", p99 " << stats.latencyP99 << ", max " << stats.latencyMax << "\n";
+    cout << "  games finished: " << gamesFinished << " / " << numSessions << "\n";
+    return (gamesFinished == numSessions) ? 0 : 1;
+}
+
+
+int othello::benchSearch(unsigned int numPositions, unsigned int depth) {
+    // mid-game positions: random games cut off after 10 to 40 moves
+    default_random_engine engine(406);
+    vector<BitBoard> positions;
+    vector<bool> sides;
+    while (positions.size() < numPositions) {
+        BitBoard pos = BitBoard::initialPosition();
+        bool blackToMove = true;
+        int numPlies = uniform_int_distribution<int>(10, 40)(engine);
+        for (int ply = 0; ply < numPlies; ply++) {
+            uint64_t legal = pos.legalMoves(blackToMove);
+            if (legal == 0) {
+                blackToMove = !blackToMove;
+                legal = pos.legalMoves(blackToMove);
+                if (legal == 0)
+                    break;
+            }
+            int pick = uniform_int_distribution<int>(0, BitBoard::popCount(legal) - 1)(engine);
+            while (pick-- > 0)
+                legal &= legal - 1;
+            pos.play(BitBoard::lowestSquare(legal), blackToMove);
+            blackToMove = !blackToMove;
+        }
+        if (pos.legalMoves(blackToMove) != 0) {
+            positions.push_back(pos);
+            sides.push_back(blackToMove);
+        }
+    }
+
+    AiMind mind(AiMind::DEFAULT_WEIGHTS, RGBColor{0.f, 0.f, 0.5f});
+    SearchArena::local(); // the arena's own memory is allocated once per thread, not per search
+    vector<int> pv;
+    pv.reserve(SearchArena::MAX_PLY + 1);
+
+    // only the searches are counted: the table, the arena & the PV buffer all exist before the first one
+    uint64_t allocations = 0, nodesBefore = mind.getNodeCount();
+    int64_t checksum = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < positions.size(); i++) {
+        uint64_t before = SearchArena::heapAllocations();
+        checksum += mind.minimax(positions[i], true, depth, sides[i], INT_MIN, INT_MAX, &pv);
+        allocations += SearchArena::heapAllocations() - before;
+    }
+    auto end = chrono::steady_clock::now();
+
+    double secs = chrono::duration<double>(end - start).count();
+    uint64_t nodes = mind.getNodeCount() - nodesBefore;
+    cout << "search benchmark: " << numPositions << " positions at depth " << depth << "\n";
+    cout << "  " << nodes << " nodes in " << secs << " s (" << (secs > 0 ? nodes / secs : 0)
+         << " nodes/sec, checksum " << checksum << ")\n";
+    if (!SearchArena::COUNTS_ALLOCATIONS) {
+        cout << "  heap allocations: not counted (build with OTHELLO_COUNT_ALLOCATIONS=1)\n";
+        return 0;
+    }
+    cout << "  heap allocations: " << allocations << " (" << (nodes > 0 ? (double)allocations / nodes : 0)
+         << " per node)\n";
+    return (allocations == 0) ? 0 : 1;
+}
+
+
+int othello::benchRender(unsigned int numCylinders, unsigned int numRows, unsigned int numCols, unsigned int numInstances,
+                         unsigned int numFrames, const char* objPath, const char* expectedChecksum) {
+    const unsigned int width = 800, height = 600;
+    OffscreenContext context(width, height);
+    if (!context.isValid())
+        return 1;
+
+    // the game's lighting (see myInit)
+    GLfloat ambientLight[] = {0.5f, 0.5f, 0.5f, 1.f};
+    GLfloat diffuseLight[] = {1.f, 1.f, 1.f, 1.f};
+    GLfloat positionLight[] = {0.f, 3.f, 3.f, 0.f};
+    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
+    glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
+    glLightfv(GL_LIGHT0, GL_POSITION, positionLight);
+    glFrontFace(GL_CW);
+    setLighting(true);
+    glEnable(GL_LIGHT0);
+    glEnable(GL_NORMALIZE);
+    glEnable(GL_DEPTH_TEST);
+    updateRenderingMode(RenderingMode::SmoothShadingRender);
+
+    // the scene: cylinders on a grid, the mesh under them, the instances above them.
+    // Everything random is seeded, so that the same arguments draw the same pictures.
+    const float spacing = 2.5f;
+    const unsigned int side = max(1U, (unsigned int) ceil(sqrt((double) max(numCylinders, numInstances))));
+    const float extent = spacing * side;
+    const Material materials[3] = {
+        {{0.2f, 0.1f, 0.1f, 1.f, 0.7f, 0.2f, 0.2f, 1.f, 0.3f, 0.3f, 0.3f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.3f}},
+        {{0.1f, 0.2f, 0.1f, 1.f, 0.2f, 0.7f, 0.2f, 1.f, 0.3f, 0.3f, 0.3f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.3f}},
+        {{0.1f, 0.1f, 0.2f, 1.f, 0.2f, 0.2f, 0.7f, 1.f, 0.3f, 0.3f, 0.3f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.3f}}
+    };
+    vector<shared_ptr<GraphicObject3D>> objects;
+    for (unsigned int i = 0; i < numCylinders; i++) {
+        float x = spacing * (i % side + 0.5f) - 0.5f * extent, y = spacing * (i / side + 0.5f) - 0.5f * extent;
+        objects.push_back(make_shared<Cylinder3D>(0.8f, 1.f, 24, 4, true, Pose{x, y, 0.f, 0.f, 0.f, 0.f}));
+        objects.back()->setMaterial(materials[i % 3]);
+    }
+    if ((numRows >= 2) && (numCols >= 2)) {
+        auto mesh = make_shared<QuadMesh3D>(extent, extent, numRows, numCols, Pose{0.f, 0.f, -0.5f, 0.f, 0.f, 0.f});
+        default_random_engine engine(406);
+        normal_distribution<float> perturbation(0.f, 0.1f);
+        for (unsigned int i = 0; i < numRows; i++)
+            for (unsigned int j = 0; j < numCols; j++)
+                mesh->displaceVertex(i, j, perturbation(engine));
+        mesh->setMaterial(materials[1]);
+        objects.push_back(mesh);
+    }
+    // what the instances' mesh came to (see MeshOptimizer)
+    unsigned int shapeVertices = 0, shapeTriangles = 0;
+    float shapeAcmr = 0.f;
+    if (numInstances > 0) {
+        shared_ptr<const Mesh> shape = MeshAssetCache::loadObj(objPath);
+        if (shape == nullptr)
+            cout << "render benchmark WARNING: no shape in " << objPath << ", no instances\n";
+        else {
+            shapeVertices = shape->numVertices();
+            shapeTriangles = shape->numTriangles();
+            shapeAcmr = MeshOptimizer::acmr(shape->triangleIndices());
+            auto batch = make_shared<InstancedMeshBatch>(shape, Pose{0.f, 0.f, 3.f, 0.f, 0.f, 0.f});
+            const GLfloat dark[4] = {0.1f, 0.1f, 0.1f, 1.f}, light[4] = {0.9f, 0.9f, 0.9f, 1.f};
+            for (unsigned int i = 0; i < numInstances; i++)
+                batch->add(Pose{spacing * (i % side + 0.5f) - 0.5f * extent, spacing * (i / side + 0.5f) - 0.5f * extent, 0.f,
+                                0.f, 0.f, 0.f}, (i % 2 == 0) ? dark : light);
+            batch->setMaterial(materials[2]);
+            objects.push_back(batch);
+        }
+    }
+    // a hierarchy over the rest (see SceneNode): a hub that turns once per run, carrying arms with a cylinder
+    // that carries a smaller, tilted one, and a stack of cylinders that never moves. The hub's branch gets
+    // its matrices recomputed every frame, the stack's only once.
+    SceneNode hierarchy(Pose{0.f, 0.f, 0.f, 0.f, 0.f, 0.f});
+    vector<shared_ptr<GraphicObject3D>> hierarchyObjects;
+    unsigned int numNodes = 1;
+    const unsigned int numArms = 8, stackHeight = 4;
+    SceneNode& hub = hierarchy.addChild(Pose{0.f, 0.f, 4.f, 0.f, 0.f, 0.f});
+    numNodes++;
+    for (unsigned int a = 0; a < numArms; a++) {
+        SceneNode& arm = hub.addChild(Pose{0.f, 0.f, 0.f, 360.f * a / numArms, 0.f, 0.f});
+        hierarchyObjects.push_back(make_shared<Cylinder3D>(0.5f, 0.8f, 24, 4, true, Pose{0.f, 0.f, 0.f, 0.f, 0.f, 0.f}));
+        hierarchyObjects.back()->setMaterial(materials[a % 3]);
+        SceneNode& base = arm.addChild(Pose{0.25f * extent, 0.f, 0.f, 0.f, 0.f, 0.f}, hierarchyObjects.back());
+        hierarchyObjects.push_back(make_shared<Cylinder3D>(0.25f, 0.5f, 16, 2, true, Pose{0.f, 0.f, 0.f, 0.f, 0.f, 0.f}));
+        hierarchyObjects.back()->setMaterial(materials[(a + 1) % 3]);
+        base.addChild(Pose{0.f, 0.f, 0.8f, 0.f, 30.f, 0.f}, hierarchyObjects.back());
+        numNodes += 3;
+    }
+    SceneNode* level = &hierarchy.addChild(Pose{-0.4f * extent, -0.4f * extent, 1.f, 0.f, 0.f, 0.f});
+    numNodes++;
+    for (unsigned int h = 0; h < stackHeight; h++) {
+        hierarchyObjects.push_back(make_shared<Cylinder3D>(0.6f - 0.1f * h, 0.8f, 24, 4, true, Pose{0.f, 0.f, 0.f, 0.f, 0.f, 0.f}));
+        hierarchyObjects.back()->setMaterial(materials[h % 3]);
+        level = &level->addChild(Pose{0.f, 0.f, 0.8f, 15.f, 0.f, 0.f}, hierarchyObjects.back());
+        numNodes++;
+    }
+
+    ObjectBVH scene;
+    scene.build(objects);
+    RenderQueue queue;
+    vector<GraphicObject3D*> visible;
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    gluPerspective(60.0, (double) width / height, 0.1, 20.0 * extent);
+
+    // one turn around the scene, looking down at it
+    auto drawFrame = [&](unsigned int frame, CullStats& cullStats) {
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glMatrixMode(GL_MODELVIEW);
+        glLoadIdentity();
+        glTranslatef(0.f, 0.f, -1.2f * extent);
+        glRotatef(-50.f, 1.f, 0.f, 0.f);
+        glRotatef(360.f * frame / numFrames, 0.f, 0.f, 1.f);
+        LevelOfDetail::beginFrame();
+        hub.setPose(Pose{0.f, 0.f, 4.f, 360.f * frame / numFrames, 0.f, 0.f});
+        hierarchy.update();
+        Frustum frustum = Frustum::fromCurrentMatrices();
+        visible.clear();
+        scene.cull(frustum, visible, cullStats);
+        frustum.cull(hierarchyObjects, visible, cullStats);
+        queue.begin();
+        for (GraphicObject3D* object : visible)
+            queue.add(*object);
+        queue.submit();
+        glFinish();
+    };
+
+    // the first frame uploads the buffers & compiles the shaders: keep it out of the timings
+    CullStats cullStats = {0, 0};
+    drawFrame(0, cullStats);
+    vector<double> frameMs;
+    unsigned long triangles = 0, drawn = 0, stateChanges = 0;
+    unsigned long matrixUpdatesBefore = SceneNode::numMatrixUpdates();
+    for (unsigned int f = 0; f < numFrames; f++) {
+        cullStats = {0, 0};
+        resetRenderStateStats();
+        auto start = chrono::steady_clock::now();
+        drawFrame(f, cullStats);
+        frameMs.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        triangles += LevelOfDetail::frameStats().trianglesDrawn;
+        drawn += cullStats.drawn;
+        const RenderStateStats& stateStats = renderStateStats();
+        stateChanges += stateStats.materialChanges + stateStats.shadeModelChanges + stateStats.lightingChanges;
+    }
+    unsigned long matrixUpdates = SceneNode::numMatrixUpdates() - matrixUpdatesBefore;
+    GLenum error = glGetError();
+
+    vector<unsigned char> pixels;
+    context.readPixels(pixels);
+    uint64_t checksum = BinaryMesh::hashBytes((const char*) pixels.data(), (const char*) pixels.data() + pixels.size());
+    char checksumText[17];
+    snprintf(checksumText, sizeof(checksumText), "%016llx", (unsigned long long) checksum);
+
+    sort(frameMs.begin(), frameMs.end());
+    auto percentile = [&frameMs](double p) {
+        return frameMs.empty() ? 0.0 : frameMs[min(frameMs.size() - 1, (size_t)(p * frameMs.size()))];
+    };
+    double totalMs = 0.0;
+    for (double ms : frameMs)
+        totalMs += ms;
+    unsigned int frames = max(1U, numFrames);
+    cout << "render benchmark: " << numCylinders << " cylinders, " << numRows << "x" << numCols << " mesh, "
+         << numInstances << " instances, " << numFrames << " frames at " << width << "x" << height << "\n";
+    cout << "  renderer: " << (const char*) glGetString(GL_RENDERER) << "\n";
+    cout << "  ms/frame: mean " << totalMs / frames << ", p50 " << percentile(0.50) << ", p90 " << percentile(0.90)
+         << ", p99 " << percentile(0.99) << ", max " << (frameMs.empty() ? 0.0 : frameMs.back()) << "\n";
+    if (shapeTriangles > 0)
+        cout << "  instance shape: " << shapeVertices << " vertices, " << shapeTriangles << " triangles, ACMR " << shapeAcmr
+             << (MeshAssetCache::optimizeMeshes() ? "" : " (not optimized)") << "\n";
+    cout << "  per frame: " << drawn / frames << " objects drawn, " << triangles / frames << " triangles (after LOD), "
+         << stateChanges / frames << " state changes\n";
+    cout << "  scene graph: " << numNodes << " nodes, " << matrixUpdates / frames << " world matrices recomputed per frame\n";
+    cout << "  checksum of the last frame: " << checksumText;
+    bool matches = (expectedChecksum == nullptr) || (strtoull(expectedChecksum, nullptr, 16) == checksum);
+    if (expectedChecksum != nullptr)
+        cout << (matches ? " (matches)" : " (MISMATCH: expected " + string(expectedChecksum) + ")");
+    cout << "\n";
+    if (error != GL_NO_ERROR)
+        cout << "  GL error " << error << "\n";
+    return (matches && (error == GL_NO_ERROR)) ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+//
+//  BinaryMesh.cpp
+//  Othello
+//
+
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "BinaryMesh.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const char BinaryMesh::MAGIC_[8] = {'O', 'T', 'H', 'M', 'E', 'S', 'H', 0};
+//    2: OBJ files without normals are cached with generated ones
+//    3: meshes are stored optimized (one indexed list)
+//    4: the header says whether the mesh was optimized
+const uint32_t BinaryMesh::VERSION_ = 4;
+
+
+BinaryMesh::BinaryMesh()
+:   file_(),
+    header_(nullptr)
+{
+    
+}
+
+
+bool BinaryMesh::open(const string& path)
+{
+    file_.reset();
+    header_ = nullptr;
+    
+    unique_ptr<MappedFile> file = make_unique<MappedFile>(path);
+    if (!file->isOpen())
+        return false;
+    if (file->size() < sizeof(BinaryMeshHeader))
+    {
+        cout << "BinaryMesh WARNING: " << path << " is too short to be a mesh, ignoring it\n";
+        return false;
+    }
+    
+    const BinaryMeshHeader* header = reinterpret_cast<const BinaryMeshHeader*>(file->begin());
+    const uint64_t numFloats = (header->hasNormals ? 6ULL : 3ULL) * header->numVertices;
+    const uint64_t expectedSize = sizeof(BinaryMeshHeader) + numFloats * sizeof(GLfloat)
+                                + uint64_t(header->numIndices) * sizeof(GLuint) + uint64_t(header->numParts) * sizeof(BinaryMeshPart);
+    const char* problem = nullptr;
+    if (memcmp(header->magic, MAGIC_, sizeof(MAGIC_)) != 0)
+        problem = "is not a binary mesh";
+    else if (header->version != VERSION_)
+        problem = "was written by another version of the loader";
+    else if (file->size() < expectedSize)
+        problem = "is truncated";
+    if (problem != nullptr)
+    {
+        cout << "BinaryMesh WARNING: " << path << " " << problem << ", ignoring it\n";
+        return false;
+    }
+    
+    file_ = std::move(file);
+    header_ = header;
+    if (!hasValidRanges_())
+    {
+        cout << "BinaryMesh WARNING: " << path << " has parts or indices out of range, ignoring it\n";
+        file_.reset();
+        header_ = nullptr;
+        return false;
+    }
+    return true;
+}
+
+
+bool BinaryMesh::hasValidRanges_() const
+{
+    //    an indexed mesh's parts are ranges of indices, the others' ranges of vertices
+    const uint64_t partLimit = header_->isIndexed ? header_->numIndices : header_->numVertices;
+    for (uint32_t p = 0; p < header_->numParts; p++)
+    {
+        if (uint64_t(parts()[p].first) + parts()[p].count > partLimit)
+            return false;
+    }
+    const GLuint* first = indices();
+    const GLuint* last = first + header_->numIndices;
+    for (const GLuint* index = first; index < last; index++)
+    {
+        if (*index >= header_->numVertices)
+            return false;
+    }
+    return true;
+}
+
+
+const GLfloat* BinaryMesh::positions() const
+{
+    return reinterpret_cast<const GLfloat*>(file_->begin() + sizeof(BinaryMeshHeader));
+}
+
+const GLfloat* BinaryMesh::normals() const
+{
+    return header_->hasNormals ? positions() + 3 * header_->numVertices : nullptr;
+}
+
+const GLuint* BinaryMesh::indices() const
+{
+    return reinterpret_cast<const GLuint*>(positions() + (header_->hasNormals ? 6 : 3) * header_->numVertices);
+}
+
+const BinaryMeshPart* BinaryMesh::parts() const
+{
+    return reinterpret_cast<const BinaryMeshPart*>(indices() + header_->numIndices);
+}
+
+
+Mesh BinaryMesh::toMesh() const
+{
+    Mesh mesh;
+    const unsigned int numFloats = 3 * header_->numVertices;
+    mesh.xyz.assign(positions(), positions() + numFloats);
+    if (header_->hasNormals)
+        mesh.normals.assign(normals(), normals() + numFloats);
+    if (header_->isIndexed)
+        mesh.indices.assign(indices(), indices() + header_->numIndices);
+    mesh.parts.reserve(header_->numParts);
+    for (uint32_t p = 0; p < header_->numParts; p++)
+        mesh.parts.push_back(MeshPart{parts()[p].mode, parts()[p].first, parts()[p].count});
+    return mesh;
+}
+
+
+bool BinaryMesh::write(const string& path, const Mesh& mesh, uint64_t sourceHash, uint64_t sourceSize, bool isOptimized)
+{
+    //    an indexed mesh's parts point into its own list
+    vector<GLuint> indices = mesh.isIndexed() ? mesh.indices : mesh.triangleIndices();
+    
+    BinaryMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC_, sizeof(MAGIC_));
+    header.version = VERSION_;
+    header.hasNormals = mesh.normals.empty() ? 0 : 1;
+    header.isIndexed = mesh.isIndexed() ? 1 : 0;
+    header.isOptimized = isOptimized ? 1 : 0;
+    header.numVertices = mesh.numVertices();
+    header.numIndices = (uint32_t) indices.size();
+    header.numParts = (uint32_t) mesh.parts.size();
+    header.sourceHash = sourceHash;
+    header.sourceSize = sourceSize;
+    for (int k = 0; k < 3; k++)
+    {
+        header.boundsMin[k] = (mesh.numVertices() > 0) ? FLT_MAX : 0.f;
+        header.boundsMax[k] = (mesh.numVertices() > 0) ? -FLT_MAX : 0.f;
+    }
+    for (size_t i = 0; i < mesh.xyz.size(); i++)
+    {
+        header.boundsMin[i % 3] = min(header.boundsMin[i % 3], mesh.xyz[i]);
+        header.boundsMax[i % 3] = max(header.boundsMax[i % 3], mesh.xyz[i]);
+    }
+    vector<BinaryMeshPart> parts;
+    for (const MeshPart& part : mesh.parts)
+        parts.push_back(BinaryMeshPart{part.mode, part.first, part.count});
+    
+    // write next to the target and rename over it
+    string tempPath = path + ".tmp";
+    ofstream file_data(tempPath, ios::binary | ios::trunc);
+    if (!file_data.is_open())
+    {
+        cout << "BinaryMesh ERROR: Unable to create file " << tempPath << "\n";
+        return false;
+    }
+    file_data.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_data.write(reinterpret_cast<const char*>(mesh.xyz.data()), (streamsize)(mesh.xyz.size() * sizeof(GLfloat)));
+    file_data.write(reinterpret_cast<const char*>(mesh.normals.data()), (streamsize)(mesh.normals.size() * sizeof(GLfloat)));
+    file_data.write(reinterpret_cast<const char*>(indices.data()), (streamsize)(indices.size() * sizeof(GLuint)));
+    file_data.write(reinterpret_cast<const char*>(parts.data()), (streamsize)(parts.size() * sizeof(BinaryMeshPart)));
+    file_data.close();
+    if (!file_data || (rename(tempPath.c_str(), path.c_str()) != 0))
+    {
+        cout << "BinaryMesh ERROR: Unable to write " << path << "\n";
+        remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+uint64_t BinaryMesh::hashBytes(const char* begin, const char* end)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL; // FNV-1a
+    for (const char* c = begin; c < end; c++)
+    {
+        hash ^= (unsigned char) *c;
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
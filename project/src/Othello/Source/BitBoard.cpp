@@ -0,0 +1,246 @@
+//
+//  BitBoard.cpp
+//  Othello
+//
+
+#include "BitBoard.hpp"
+
+using namespace othello;
+
+namespace {
+    // The 8 directions as bit shifts: E, W, N, S, NE, NW, SE, SW.
+    // The masks clear the squares that a shift would wrap around from the opposite edge.
+    const int DIR_SHIFTS[8] = {1, -1, 8, -8, 9, 7, -7, -9};
+    const uint64_t DIR_MASKS[8] = {
+        0xFEFEFEFEFEFEFEFEULL, 0x7F7F7F7F7F7F7F7FULL, 0xFFFFFFFFFFFFFFFFULL, 0xFFFFFFFFFFFFFFFFULL,
+        0xFEFEFEFEFEFEFEFEULL, 0x7F7F7F7F7F7F7F7FULL, 0xFEFEFEFEFEFEFEFEULL, 0x7F7F7F7F7F7F7F7FULL
+    };
+
+    inline uint64_t shiftDir(uint64_t bits, int d) {
+        int s = DIR_SHIFTS[d];
+        return (s > 0 ? (bits << s) : (bits >> -s)) & DIR_MASKS[d];
+    }
+}
+
+
+BitBoard BitBoard::initialPosition() {
+    BitBoard start{0, 0};
+    start.white |= 1ULL << squareIndex(TilePoint{4, 4});
+    start.white |= 1ULL << squareIndex(TilePoint{5, 5});
+    start.black |= 1ULL << squareIndex(TilePoint{4, 5});
+    start.black |= 1ULL << squareIndex(TilePoint{5, 4});
+    return start;
+}
+
+uint64_t BitBoard::legalMoves(uint64_t mine, uint64_t theirs) {
+    uint64_t empty = ~(mine | theirs);
+    uint64_t moves = 0;
+    for (int d = 0; d < 8; d++) {
+        // grow runs of opponent discs outward from my discs (at most 6 in a row fit on the board)
+        uint64_t run = shiftDir(mine, d) & theirs;
+        run |= shiftDir(run, d) & theirs;
+        run |= shiftDir(run, d) & theirs;
+        run |= shiftDir(run, d) & theirs;
+        run |= shiftDir(run, d) & theirs;
+        run |= shiftDir(run, d) & theirs;
+        moves |= shiftDir(run, d) & empty;
+    }
+    return moves;
+}
+
+uint64_t BitBoard::flips(int sq, uint64_t mine, uint64_t theirs) {
+    uint64_t flipped = 0;
+    uint64_t origin = 1ULL << sq;
+    for (int d = 0; d < 8; d++) {
+        uint64_t line = 0;
+        uint64_t next = shiftDir(origin, d);
+        while (next & theirs) {
+            line |= next;
+            next = shiftDir(next, d);
+        }
+        // the run only counts if it ends on one of my discs
+        if (next & mine)
+            flipped |= line;
+    }
+    return flipped;
+}
+
+uint64_t BitBoard::shift(uint64_t bits, int dir) {
+    return shiftDir(bits, dir);
+}
+
+uint64_t BitBoard::neighbors(uint64_t bits) {
+    uint64_t around = 0;
+    for (int d = 0; d < NUM_DIRECTIONS; d++)
+        around |= shiftDir(bits, d);
+    return around & ~bits;
+}
+
+bool BitBoard::play(int sq, bool forBlack) {
+    uint64_t bit = 1ULL << sq;
+    if (occupied() & bit)
+        return false;
+    uint64_t& mine = forBlack ? black : white;
+    uint64_t& theirs = forBlack ? white : black;
+    uint64_t flipped = flips(sq, mine, theirs);
+    if (flipped == 0)
+        return false;
+    mine |= flipped | bit;
+    theirs &= ~flipped;
+    return true;
+}
+
+int BitBoard::popCount(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bits);
+#else
+    int count = 0;
+    while (bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+// The four transforms below are the classic delta-swap formulations: each one
+// swaps groups of bits in log2(8) = 3 passes, with no loops or table lookups.
+
+uint64_t BitBoard::flipVertical(uint64_t bits) {
+    // swap the 8 rows (bytes)
+    const uint64_t k1 = 0x00FF00FF00FF00FFULL;
+    const uint64_t k2 = 0x0000FFFF0000FFFFULL;
+    bits = ((bits >>  8) & k1) | ((bits & k1) <<  8);
+    bits = ((bits >> 16) & k2) | ((bits & k2) << 16);
+    bits = ( bits >> 32)       | ( bits       << 32);
+    return bits;
+}
+
+uint64_t BitBoard::mirrorHorizontal(uint64_t bits) {
+    // reverse the bits inside each row
+    const uint64_t k1 = 0x5555555555555555ULL;
+    const uint64_t k2 = 0x3333333333333333ULL;
+    const uint64_t k4 = 0x0F0F0F0F0F0F0F0FULL;
+    bits = ((bits >> 1) & k1) | ((bits & k1) << 1);
+    bits = ((bits >> 2) & k2) | ((bits & k2) << 2);
+    bits = ((bits >> 4) & k4) | ((bits & k4) << 4);
+    return bits;
+}
+
+uint64_t BitBoard::flipDiagonal(uint64_t bits) {
+    // square (x, y) <-> (y, x)
+    const uint64_t k1 = 0x5500550055005500ULL;
+    const uint64_t k2 = 0x3333000033330000ULL;
+    const uint64_t k4 = 0x0F0F0F0F00000000ULL;
+    uint64_t t;
+    t = k4 & (bits ^ (bits << 28));
+    bits ^= t ^ (t >> 28);
+    t = k2 & (bits ^ (bits << 14));
+    bits ^= t ^ (t >> 14);
+    t = k1 & (bits ^ (bits << 7));
+    bits ^= t ^ (t >> 7);
+    return bits;
+}
+
+uint64_t BitBoard::flipAntiDiagonal(uint64_t bits) {
+    // square (x, y) <-> (7-y, 7-x)
+    const uint64_t k1 = 0xAA00AA00AA00AA00ULL;
+    const uint64_t k2 = 0xCCCC0000CCCC0000ULL;
+    const uint64_t k4 = 0xF0F0F0F00F0F0F0FULL;
+    uint64_t t;
+    t = bits ^ (bits << 36);
+    bits ^= k4 & (t ^ (bits >> 36));
+    t = k2 & (bits ^ (bits << 18));
+    bits ^= t ^ (t >> 18);
+    t = k1 & (bits ^ (bits << 9));
+    bits ^= t ^ (t >> 9);
+    return bits;
+}
+
+uint64_t BitBoard::transformBits(uint64_t bits, Symmetry sym) {
+    switch (sym) {
+        case Symmetry::IDENTITY:
+            return bits;
+        case Symmetry::FLIP_VERTICAL:
+            return flipVertical(bits);
+        case Symmetry::MIRROR_HORIZONTAL:
+            return mirrorHorizontal(bits);
+        case Symmetry::ROTATE_180:
+            return flipVertical(mirrorHorizontal(bits));
+        case Symmetry::FLIP_DIAGONAL:
+            return flipDiagonal(bits);
+        case Symmetry::FLIP_ANTI_DIAGONAL:
+            return flipAntiDiagonal(bits);
+        case Symmetry::ROTATE_90:
+            return flipVertical(flipDiagonal(bits));
+        case Symmetry::ROTATE_270:
+            return flipDiagonal(flipVertical(bits));
+        default:
+            return bits;
+    }
+}
+
+Symmetry BitBoard::inverse(Symmetry sym) {
+    // every symmetry is its own inverse except the two quarter turns
+    if (sym == Symmetry::ROTATE_90)
+        return Symmetry::ROTATE_270;
+    if (sym == Symmetry::ROTATE_270)
+        return Symmetry::ROTATE_90;
+    return sym;
+}
+
+int BitBoard::lowestSquare(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bits);
+#else
+    int index = 0;
+    while (!(bits & 1ULL)) {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+int BitBoard::transformSquare(int sq, Symmetry sym) {
+    // going through transformBits guarantees moves and boards are mapped identically
+    return lowestSquare(transformBits(1ULL << sq, sym));
+}
+
+BitBoard BitBoard::transformed(Symmetry sym) const {
+    return BitBoard{transformBits(black, sym), transformBits(white, sym)};
+}
+
+BitBoard BitBoard::canonical(Symmetry& used) const {
+    // build the 8 forms incrementally from the 3 elementary transforms,
+    // so each form costs at most one delta-swap pass per color
+    const uint64_t vB = flipVertical(black), vW = flipVertical(white);
+    const uint64_t hB = mirrorHorizontal(black), hW = mirrorHorizontal(white);
+    const uint64_t rB = flipVertical(hB), rW = flipVertical(hW);
+    const uint64_t dB = flipDiagonal(black), dW = flipDiagonal(white);
+    const BitBoard forms[static_cast<int>(Symmetry::NB_SYMMETRIES)] = {
+        {black, white},                                 // IDENTITY
+        {vB, vW},                                       // FLIP_VERTICAL
+        {hB, hW},                                       // MIRROR_HORIZONTAL
+        {rB, rW},                                       // ROTATE_180
+        {dB, dW},                                       // FLIP_DIAGONAL
+        {flipDiagonal(rB), flipDiagonal(rW)},           // FLIP_ANTI_DIAGONAL
+        {flipVertical(dB), flipVertical(dW)},           // ROTATE_90
+        {flipDiagonal(vB), flipDiagonal(vW)},           // ROTATE_270
+    };
+    int best = 0;
+    for (int s = 1; s < static_cast<int>(Symmetry::NB_SYMMETRIES); s++) {
+        if (forms[s] < forms[best])
+            best = s;
+    }
+    used = static_cast<Symmetry>(best);
+    return forms[best];
+}
+
+uint64_t BitBoard::hash() const {
+    // splitmix64 finalizer over both colors
+    uint64_t h = black * 0x9E3779B97F4A7C15ULL ^ (white + 0xBF58476D1CE4E5B9ULL);
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
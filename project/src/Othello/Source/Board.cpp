@@ -26,7 +26,9 @@ Board::Board(RGBColor tileColor, std::shared_ptr<Player>& nullplayerRef)
         GraphicObject(0, 0, 0),
         DEFAULT_TILE_COLOR_(tileColor),
         nullplayerRef_(nullplayerRef),
-        allBoardTiles_(std::vector<std::vector<std::shared_ptr<Tile>>>())
+        allBoardTiles_(std::vector<std::vector<std::shared_ptr<Tile>>>()),
+        tileLayerList_(0),
+        tileLayerValid_(false)
 {
     TilePoint thisPnt;
     for (int c = 1; c <= 8; c++) {
@@ -39,6 +41,12 @@ Board::Board(RGBColor tileColor, std::shared_ptr<Player>& nullplayerRef)
     }
 }
 
+Board::~Board() {
+    // the list only exists if the board was ever drawn, i.e. if there is a GL context to delete it from
+    if (tileLayerList_ != 0)
+        glDeleteLists(tileLayerList_, 1);
+}
+
 std::vector<std::shared_ptr<Disc>> Board::getAllPieces() const {
     std::vector<std::shared_ptr<Disc>> pieces;
     for (unsigned int r = 0; r < allBoardTiles_.size(); r++) {
@@ -77,6 +85,9 @@ void Board::setScalingRatios(int& paneWidth, int& paneHeight){
 	
 	paneWidth = static_cast<int>(round(WIDTH_ * worldToPixelRatio));
 	paneHeight = static_cast<int>(round(HEIGHT_ * worldToPixelRatio));
+	
+	// the window was resized
+	invalidateTileLayer();
 }
 
 TilePoint Board::pixelToWorld(float ix, float iy)
@@ -179,12 +190,30 @@ void Board::getNeighbors(TilePoint& tile, std::vector<std::shared_ptr<Tile>>& ne
 }
 
 void Board::draw() const {
-    // draw all constituent tiles
-    for (int i = 0; i < allBoardTiles_.size(); i++) {
-        for (auto tile : allBoardTiles_.at(i)) {
-            if (tile != nullptr) {
-                tile->draw();
+    if (!tileLayerValid_) {
+        if (tileLayerList_ == 0)
+            tileLayerList_ = glGenLists(1);
+        // draw all constituent tiles into the list
+        glNewList(tileLayerList_, GL_COMPILE);
+        for (int i = 0; i < allBoardTiles_.size(); i++) {
+            for (auto tile : allBoardTiles_.at(i)) {
+                if (tile != nullptr) {
+                    tile->draw();
+                }
             }
         }
+        glEndList();
+        tileLayerValid_ = true;
+    }
+    glCallList(tileLayerList_);
+}
+
+
+void Board::setTileColor(RGBColor tileColor) {
+    DEFAULT_TILE_COLOR_ = tileColor;
+    for (auto& row : allBoardTiles_) {
+        for (auto& tile : row)
+            tile->setColor(tileColor);
     }
+    invalidateTileLayer();
 }
@@ -0,0 +1,84 @@
+//
+//  Bounds3D.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include "Bounds3D.h"
+
+using namespace std;
+using namespace graphics3d;
+
+
+Bounds3D Bounds3D::empty()
+{
+    return Bounds3D{{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}};
+}
+
+
+Bounds3D Bounds3D::fromPoints(const GLfloat* xyz, size_t numPoints)
+{
+    Bounds3D box = empty();
+    for (size_t p = 0; p < numPoints; p++)
+        box.add(xyz + 3*p);
+    return box;
+}
+
+
+void Bounds3D::add(const float point[3])
+{
+    for (int k = 0; k < 3; k++)
+    {
+        min[k] = std::min(min[k], point[k]);
+        max[k] = std::max(max[k], point[k]);
+    }
+}
+
+
+void Bounds3D::add(const Bounds3D& other)
+{
+    if (other.isEmpty())
+        return;
+    add(other.min);
+    add(other.max);
+}
+
+
+BoundingSphere Bounds3D::sphere() const
+{
+    BoundingSphere ball;
+    float halfDiagonal2 = 0.f;
+    for (int k = 0; k < 3; k++)
+    {
+        ball.center[k] = 0.5f * (min[k] + max[k]);
+        float half = 0.5f * (max[k] - min[k]);
+        halfDiagonal2 += half * half;
+    }
+    ball.radius = sqrtf(halfDiagonal2);
+    return ball;
+}
+
+
+Bounds3D Bounds3D::transformed(const GLfloat rows[12]) const
+{
+    if (isEmpty())
+        return *this;
+    //    center & extent (Arvo): the new half extent along an axis is the sum of the
+    //    half extents projected on it
+    Bounds3D box;
+    for (int i = 0; i < 3; i++)
+    {
+        const GLfloat* row = rows + 4*i;
+        float center = row[3], extent = 0.f;
+        for (int k = 0; k < 3; k++)
+        {
+            center += row[k] * 0.5f * (min[k] + max[k]);
+            extent += fabsf(row[k]) * 0.5f * (max[k] - min[k]);
+        }
+        box.min[i] = center - extent;
+        box.max[i] = center + extent;
+    }
+    return box;
+}
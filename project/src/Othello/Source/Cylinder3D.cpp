@@ -6,15 +6,21 @@
 //
 
 #include "Cylinder3D.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 using namespace std;
 using namespace graphics3d;
 
 
-const shared_ptr<Cylinder3D> UNIT_CYLINDER_OPEN = make_shared<Cylinder3D>(
+const unsigned int Cylinder3D::MIN_LOD_CIRCLE_PTS = 6;
+const unsigned int Cylinder3D::MAX_LOD_LEVELS = 4;
+
+const shared_ptr<Cylinder3D> Cylinder3D::UNIT_CYLINDER_OPEN = make_shared<Cylinder3D>(
                 1.f, 1.f, 1.f, 12, 12, false,
                 Pose{0.f, 0.f, 0.f});
-const shared_ptr<Cylinder3D> UNIT_CYLINDER_CLOSED = make_shared<Cylinder3D>(
+const shared_ptr<Cylinder3D> Cylinder3D::UNIT_CYLINDER_CLOSED = make_shared<Cylinder3D>(
                 1.f, 1.f, 1.f, 12, 12, true,
                 Pose{0.f, 0.f, 0.f});
             
@@ -30,12 +36,25 @@ Cylinder3D::Cylinder3D(float radiusX, float radiusY, float height,
         numCirclePts_(numCirclePts),
         numRings_(numRings),
         isClosed_(isClosed),
-        XYZ_(nullptr),
-        normals_(nullptr),
-        topNormal_(nullptr),
-        bottomNormal_(nullptr)
+        meshes_(),
+        lod_()
 {
-    initMeshAndNormals_();
+    unsigned int circlePts = numCirclePts, rings = numRings;
+    do
+    {
+        ostringstream name;
+        name << "Cylinder3D " << radiusX << " " << radiusY << " " << height << " "
+             << circlePts << " " << rings << (isClosed ? " closed" : " open");
+        meshes_.push_back(MeshAssetCache::getOrBuild(name.str(), [=]() {
+            return buildMesh_(radiusX, radiusY, height, circlePts, rings, isClosed);
+        }));
+        //    the silhouette is what shows the tessellation: pi steps around for one across
+        lod_.addLevel(circlePts / M_PI, meshes_.back()->numTriangles());
+        circlePts /= 2;
+        rings = max(1U, rings / 2);
+    }
+    while ((meshes_.size() < MAX_LOD_LEVELS) && (circlePts >= MIN_LOD_CIRCLE_PTS));
+    setLocalBounds(Bounds3D::fromPoints(meshes_[0]->xyz.data(), meshes_[0]->numVertices()));
 }
 
 Cylinder3D::Cylinder3D(float radius, float height,
@@ -46,144 +65,66 @@ Cylinder3D::Cylinder3D(float radius, float height,
                    isClosed, pose, motion)
 {}
 
-Cylinder3D::~Cylinder3D()
+void Cylinder3D::drawShape() const
 {
-    for (unsigned int i=0; i<numRings_; i++)
-    {
-        for (unsigned int j=0; j<numCirclePts_; j++)
-        {
-            delete []XYZ_[i][j];
-        }
-        delete []XYZ_[i];
-    }
-    delete []XYZ_;
-
-    for (unsigned int j=0; j<numCirclePts_; j++)
-    {
-        delete []normals_[j];
-    }
-    delete []normals_;
-
-    if (isClosed_)
-    {
-        delete [] topNormal_;
-        delete [] bottomNormal_;
-    }
-}
-
-
-void Cylinder3D::draw() const
-{
-    glPushMatrix();
-    applyPose();
-
     setCurrentMaterial(getMaterial());
 
-    //    draw all the rings
-    for (unsigned int i=0; i<numRings_; i++)
-    {
-        glBegin(GL_TRIANGLE_STRIP);
-            for (unsigned int j=0; j<numCirclePts_; j++)
-            {
-                glNormal3fv(normals_[j]);
-                glVertex3fv(XYZ_[i][j]);
-                glNormal3fv(normals_[j]);
-                glVertex3fv(XYZ_[i+1][j]);
-            }
-            // close the ring
-            glNormal3fv(normals_[0]);
-            glVertex3fv(XYZ_[i][0]);
-            glNormal3fv(normals_[0]);
-            glVertex3fv(XYZ_[i+1][0]);
-            
-        glEnd();
-    }
-    
-    //    If the cylinder is closed, we have to draw the top and bottom sides
-    if (isClosed_)
-    {
-        //    top
-        //-----------------------------------
-        glBegin(GL_TRIANGLE_FAN);
-            //    center
-            glNormal3fv(topNormal_);
-            glVertex3f(0.f, 0.f, height_);
-
-            glNormal3fv(topNormal_);
-            glVertex3fv(XYZ_[numRings_][0]);
-
-            //    For whatever reason, fans list vertices in clockwise order [???]
-            for (unsigned int j=0, jp=numCirclePts_-1; j<numCirclePts_; j++, jp--)
-            {
-                glNormal3fv(topNormal_);
-                glVertex3fv(XYZ_[numRings_][jp]);
-            }
-        glEnd();
-        
-        //    bottom
-        //-----------------------------------
-        glBegin(GL_TRIANGLE_FAN);
-            //    center
-            glNormal3fv(bottomNormal_);
-            glVertex3f(0.f, 0.f, 0.f);
-            for (unsigned int j=0; j<numCirclePts_; j++)
-            {
-                glNormal3fv(bottomNormal_);
-                glVertex3fv(XYZ_[0][j]);
-            }
-            glNormal3fv(bottomNormal_);
-            glVertex3fv(XYZ_[0][0]);
-        glEnd();
-    }
-
-    glPopMatrix();
+    meshes_[lod_.select(getWorldSphere())]->draw();
 }
 
-void Cylinder3D::initMeshAndNormals_()
+Mesh Cylinder3D::buildMesh_(float radiusX, float radiusY, float height,
+                            unsigned int numCirclePts, unsigned int numRings, bool isClosed)
 {
-    //    Allocate arraus of vertex coordinates and normals
-    XYZ_ = new GLfloat**[numRings_+1];
-    for (unsigned int i=0; i<=numRings_; i++)
+    Mesh mesh;
+    auto addVertex = [&mesh](float x, float y, float z, float nx, float ny, float nz)
     {
-        XYZ_[i] = new GLfloat*[numCirclePts_];
-        for (unsigned int j=0; j<numCirclePts_; j++)
-        {
-            XYZ_[i][j] = new GLfloat[3];
-        }
-    }
-    normals_ = new GLfloat*[numCirclePts_];
-    for (unsigned int j=0; j<numCirclePts_; j++)
+        mesh.xyz.insert(mesh.xyz.end(), {x, y, z});
+        mesh.normals.insert(mesh.normals.end(), {nx, ny, nz});
+    };
+    
+    //    Ring coordinates and normals
+    vector<float> ct(numCirclePts), st(numCirclePts);
+    for (unsigned int j=0; j<numCirclePts; j++)
     {
-        normals_[j] = new GLfloat[3];
+        float theta = 2*j*M_PI/numCirclePts;
+        ct[j] = cosf(theta);
+        st[j] = sinf(theta);
     }
     
-    //    Now initialize the vertex and normal coordinates
-    //    Here I work with the ring as outer loop
-    for (unsigned int j=0; j<numCirclePts_; j++)
+    //    all the rings
+    for (unsigned int i=0; i<numRings; i++)
     {
-        float theta = 2*j*M_PI/numCirclePts_;
-        float ct = cosf(theta), st = sinf(theta);
-        
-        for (unsigned int i=0; i<=numRings_; i++)
+        float z0 = height*i/numRings, z1 = height*(i+1)/numRings;
+        MeshPart strip{GL_TRIANGLE_STRIP, mesh.numVertices(), 2*(numCirclePts+1)};
+        //    the normals (outward, perpendicular to the ellipse) are constant along a slab; the last pair closes the ring
+        for (unsigned int k=0; k<=numCirclePts; k++)
         {
-            XYZ_[i][j][0] = radiusX_*ct;
-            XYZ_[i][j][1] = radiusY_*st;
-            XYZ_[i][j][2] = height_*i/numRings_;
+            unsigned int j = k % numCirclePts;
+            addVertex(radiusX*ct[j], radiusY*st[j], z0, ct[j]*radiusY, st[j]*radiusX, 0.f);
+            addVertex(radiusX*ct[j], radiusY*st[j], z1, ct[j]*radiusY, st[j]*radiusX, 0.f);
         }
-        
-        //    the normals are constant along a slab
-        normals_[j][0] = ct*radiusY_;
-        normals_[j][1] = -st*radiusX_;
-        normals_[j][2] = 0.f;
+        mesh.parts.push_back(strip);
     }
     
-    //    And take care of top and bottom sides if the cylinder is closed
-    if (isClosed_)
+    //    If the cylinder is closed, we have to draw the top and bottom sides
+    if (isClosed)
     {
-        topNormal_ = new GLfloat[3];
-        bottomNormal_ = new GLfloat[3];
-        topNormal_[0] = topNormal_[1] = bottomNormal_[0] = bottomNormal_[1] = 0.f;
-        topNormal_[2] = 1.f;
-        bottomNormal_[2] = -1.f;
+        //    top
+        //    For whatever reason, fans list vertices in clockwise order [???]
+        MeshPart top{GL_TRIANGLE_FAN, mesh.numVertices(), numCirclePts+2};
+        addVertex(0.f, 0.f, height, 0.f, 0.f, 1.f);
+        addVertex(radiusX*ct[0], radiusY*st[0], height, 0.f, 0.f, 1.f);
+        for (unsigned int j=0, jp=numCirclePts-1; j<numCirclePts; j++, jp--)
+            addVertex(radiusX*ct[jp], radiusY*st[jp], height, 0.f, 0.f, 1.f);
+        mesh.parts.push_back(top);
+        
+        //    bottom
+        MeshPart bottom{GL_TRIANGLE_FAN, mesh.numVertices(), numCirclePts+2};
+        addVertex(0.f, 0.f, 0.f, 0.f, 0.f, -1.f);
+        for (unsigned int j=0; j<numCirclePts; j++)
+            addVertex(radiusX*ct[j], radiusY*st[j], 0.f, 0.f, 0.f, -1.f);
+        addVertex(radiusX*ct[0], radiusY*st[0], 0.f, 0.f, 0.f, -1.f);
+        mesh.parts.push_back(bottom);
     }
+    return mesh;
 }
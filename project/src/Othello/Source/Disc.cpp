@@ -6,33 +6,39 @@
 //
 
 #include "Disc.hpp"
+#include <mutex>
 
 using namespace othello;
 
 const unsigned int Disc::_numCirPoints = 18;
-float** Disc::_circlePoints;
+float** Disc::_circlePoints = nullptr;
+
+namespace {
+    // the circle table is shared by all discs, so only the first disc builds it
+    // (the AI builds discs from several threads at once when annotating games)
+    std::once_flag circlePointsInit;
+}
 
 Disc::Disc(TilePoint& loc, RGBColor color)
     :   Object(loc, 0),
         GraphicObject(loc, 0),
         AnimatedObject(loc, 0, 0, 0, 0),
         color_(color),
-        size_(0.37),
-        switchColorAfter_(-1),
-        curSwitchTimer_(0),
-        colorToSwitchTo_(RGBColor{-1, -1, -1})
+        size_(0.37)
 {
-    _circlePoints = new float*[_numCirPoints];
-    for (int k=0; k < _numCirPoints; k++) {
-        _circlePoints[k] = new float[2];
-    }
-    float angleStep = 2.f*M_PI/_numCirPoints;
-    float theta;
-    for (int k = 0; k < _numCirPoints; k++) {
-        theta = k * angleStep;
-        _circlePoints[k][0] = cosf(theta) * size_;
-        _circlePoints[k][1] = sinf(theta) * size_;
-    }
+    std::call_once(circlePointsInit, [this]() {
+        _circlePoints = new float*[_numCirPoints];
+        for (int k=0; k < _numCirPoints; k++) {
+            _circlePoints[k] = new float[2];
+        }
+        float angleStep = 2.f*M_PI/_numCirPoints;
+        float theta;
+        for (int k = 0; k < _numCirPoints; k++) {
+            theta = k * angleStep;
+            _circlePoints[k][0] = cosf(theta) * size_;
+            _circlePoints[k][1] = sinf(theta) * size_;
+        }
+    });
 }
 
 void Disc::draw() const
@@ -61,16 +67,3 @@ void Disc::draw() const
     glPopMatrix();
     
 }
-
-void Disc::update(float dt) {
-    if (switchColorAfter_ > -1) {
-        curSwitchTimer_ += dt;
-        if (curSwitchTimer_ >= switchColorAfter_) {
-            color_ = colorToSwitchTo_;
-            switchColorAfter_ = -1;
-        }
-    } else {
-        colorToSwitchTo_ = RGBColor{-1, -1, -1};
-        curSwitchTimer_ = 0;
-    }
-}
@@ -0,0 +1,303 @@
+//
+//  EngineProtocol.cpp
+//  Othello
+//
+
+#include "EngineProtocol.hpp"
+#include "GameDatabase.hpp"
+#include <cctype>
+#include <memory>
+
+using namespace std;
+using namespace othello;
+
+
+const size_t EngineProtocol::CACHE_MAX_ENTRIES_ = size_t(1) << 20;
+
+
+namespace {
+    /// Parses a coordinate such as "f5" (either case) into a square index, or returns -1.
+    int parseSquare(const string& word) {
+        if (word.size() != 2)
+            return -1;
+        char letter = (char)tolower(word[0]);
+        char digit = word[1];
+        if ((letter < 'a') || (letter > 'h') || (digit < '1') || (digit > '8'))
+            return -1;
+        return BitBoard::squareIndex(TilePoint{letter - 'a' + 1, digit - '0'});
+    }
+}
+
+
+EngineProtocol::EngineProtocol(istream& in, ostream& out)
+    :
+    in_(in),
+    out_(out),
+    mind_(AiMind::DEFAULT_WEIGHTS, RGBColor{0.f, 0.f, 0.5f}),
+    position_(BitBoard::initialPosition()),
+    blackToMove_(true),
+    stopFlag_(false),
+    searching_(false),
+    limits_{0, 0, 0.0, nullptr},
+    useClock_(false),
+    clock_{0.0, 0.0},
+    multiPv_(1)
+{
+
+}
+
+EngineProtocol::~EngineProtocol() {
+    stopFlag_ = true;
+    joinSearch_();
+}
+
+
+void EngineProtocol::send_(const string& line) {
+    lock_guard<mutex> lock(outMutex_);
+    out_ << line << endl;
+}
+
+
+string EngineProtocol::moveList_(const vector<int>& moves) {
+    string list;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (i > 0)
+            list += ' ';
+        list += GameDatabase::squareName(moves[i]);
+    }
+    return list;
+}
+
+
+void EngineProtocol::joinSearch_() {
+    if (searchThread_.joinable())
+        searchThread_.join();
+}
+
+
+int EngineProtocol::run() {
+    string line;
+    while (getline(in_, line)) {
+        istringstream args(line);
+        string command;
+        if (!(args >> command))
+            continue;
+
+        if (command == "quit") {
+            break;
+        } else if (command == "stop") {
+            stopFlag_ = true;
+            joinSearch_();
+        } else if (command == "isready") {
+            send_("readyok");
+        } else if (searching_ && ((command == "newgame") || (command == "position") || (command == "moves") || (command == "go"))) {
+            // the position can't change under a running search
+            send_("error search in progress, send stop first");
+        } else if (command == "newgame") {
+            joinSearch_();
+            position_ = BitBoard::initialPosition();
+            blackToMove_ = true;
+        } else if (command == "position") {
+            joinSearch_();
+            setPosition_(args);
+        } else if (command == "moves") {
+            joinSearch_();
+            playMoves_(args, position_, blackToMove_);
+        } else if (command == "go") {
+            joinSearch_();
+            startSearch_(args);
+        } else {
+            send_("error unknown command " + command);
+        }
+    }
+    stopFlag_ = true;
+    joinSearch_();
+    if (!cachePath_.empty())
+        cache_->save(cachePath_.c_str(), mind_.getTranspositionTable(), mind_.evalFingerprint(), CACHE_MAX_ENTRIES_);
+    return 0;
+}
+
+
+void EngineProtocol::useCacheFile(const char* filepath) {
+    cachePath_ = filepath;
+    cache_ = make_shared<PersistentCache>();
+    cache_->open(filepath, mind_.evalFingerprint());
+    mind_.setPersistentCache(cache_);
+}
+
+
+void EngineProtocol::setPosition_(istringstream& args) {
+    string word;
+    BitBoard pos{0, 0};
+    bool blackToMove = true;
+    args >> word;
+    if (word == "startpos") {
+        pos = BitBoard::initialPosition();
+    } else if (word == "board") {
+        string squares, side;
+        if (!(args >> squares >> side) || (squares.size() != BitBoard::NUM_SQUARES) || ((side != "b") && (side != "w"))) {
+            send_("error expected: position board <64 squares> <b|w>");
+            return;
+        }
+        for (int sq = 0; sq < BitBoard::NUM_SQUARES; sq++) {
+            char c = (char)toupper(squares[sq]);
+            if ((c == 'X') || (c == 'B') || (c == '*'))
+                pos.black |= 1ULL << sq;
+            else if ((c == 'O') || (c == 'W'))
+                pos.white |= 1ULL << sq;
+            else if ((c != '-') && (c != '.')) {
+                send_(string("error bad square character ") + squares[sq]);
+                return;
+            }
+        }
+        blackToMove = (side == "b");
+    } else {
+        send_("error expected: position startpos|board ...");
+        return;
+    }
+
+    if (args >> word) {
+        if (word != "moves") {
+            send_("error unexpected " + word);
+            return;
+        }
+        if (!playMoves_(args, pos, blackToMove))
+            return;
+    }
+    position_ = pos;
+    blackToMove_ = blackToMove;
+}
+
+
+bool EngineProtocol::playMoves_(istringstream& args, BitBoard& pos, bool& blackToMove) {
+    BitBoard newPos = pos;
+    bool newBlackToMove = blackToMove;
+    string word;
+    while (args >> word) {
+        if ((word == "pass") || (word == "pa") || (word == "--")) {
+            if (newPos.legalMoves(newBlackToMove) != 0) {
+                send_("error illegal pass, there are legal moves");
+                return false;
+            }
+            newBlackToMove = !newBlackToMove;
+            continue;
+        }
+        int sq = parseSquare(word);
+        // forced passes may be left out, as in recorded games
+        if ((sq < 0) || !GameDatabase::playMove(newPos, newBlackToMove, sq)) {
+            send_("error illegal move " + word);
+            return false;
+        }
+    }
+    pos = newPos;
+    blackToMove = newBlackToMove;
+    return true;
+}
+
+
+void EngineProtocol::startSearch_(istringstream& args) {
+    SearchLimits limits{0, 0, 0.0, &stopFlag_};
+    unsigned int multiPv = 1;
+    // clocks in milliseconds, indexed [black, white]; -1 = not given
+    long long time[2] = {-1, -1}, increment[2] = {0, 0};
+    string word;
+    while (args >> word) {
+        if (word == "infinite")
+            continue;
+        long long value;
+        if (!(args >> value) || (value < 0)) {
+            send_("error expected a number after " + word);
+            return;
+        }
+        if (word == "depth")
+            limits.maxDepth = (unsigned int)value;
+        else if (word == "movetime")
+            limits.maxSeconds = value / 1000.0;
+        else if (word == "nodes")
+            limits.maxNodes = (uint64_t)value;
+        else if (word == "btime")
+            time[0] = value;
+        else if (word == "wtime")
+            time[1] = value;
+        else if (word == "binc")
+            increment[0] = value;
+        else if (word == "winc")
+            increment[1] = value;
+        else if (word == "multipv")
+            multiPv = (unsigned int)value;
+        else {
+            send_("error unknown search limit " + word);
+            return;
+        }
+    }
+    int side = blackToMove_ ? 0 : 1;
+    useClock_ = (time[side] >= 0);
+    clock_ = GameClock{time[side] / 1000.0, increment[side] / 1000.0};
+    limits_ = limits;
+    multiPv_ = multiPv;
+    stopFlag_ = false;
+    searching_ = true;
+    searchThread_ = thread(&EngineProtocol::search_, this, position_, blackToMove_);
+}
+
+
+void EngineProtocol::search_(BitBoard pos, bool blackToMove) {
+    if (pos.legalMoves(blackToMove) == 0) {
+        // either a forced pass, or nobody can move and the game is over
+        searching_ = false;
+        send_(pos.legalMoves(!blackToMove) != 0 ? "bestmove pass" : "bestmove none");
+        return;
+    }
+
+    // with a game clock, the time manager picks this move's budget (an explicit movetime still caps it)
+    unique_ptr<TimeManager> timeManager;
+    if (useClock_) {
+        timeManager = make_unique<TimeManager>(clock_, BitBoard::popCount(pos.empties()));
+        if ((limits_.maxSeconds == 0) || (timeManager->getHardLimit() < limits_.maxSeconds))
+            limits_.maxSeconds = timeManager->getHardLimit();
+    }
+
+    if (multiPv_ != 1) {
+        searchMultiPv_(pos, blackToMove, timeManager.get());
+        return;
+    }
+
+    SearchInfo result = mind_.searchIterative(pos, blackToMove, limits_, [this, &timeManager](const SearchInfo& info) {
+        ostringstream line;
+        line << "info depth " << info.depth << " score " << info.score << " nodes " << info.nodes
+             << " time " << (long long)(info.seconds * 1000.0)
+             << " nps " << (long long)(info.seconds > 0 ? info.nodes / info.seconds : 0)
+             << " pv " << moveList_(info.pv);
+        send_(line.str());
+        return !timeManager || timeManager->continueSearch(info);
+    });
+    // clear the flag first: the manager may answer the bestmove line with a new command right away
+    searching_ = false;
+    send_("bestmove " + GameDatabase::squareName(result.bestMove));
+}
+
+
+void EngineProtocol::searchMultiPv_(BitBoard pos, bool blackToMove, TimeManager* timeManager) {
+    MultiPvInfo result = mind_.searchMultiPv(pos, blackToMove, multiPv_, limits_, [this, timeManager](const MultiPvInfo& info) {
+        // the protocol only reports completed iterations, partial ones are for interactive hints
+        if (info.movesSearched < info.numMoves)
+            return true;
+        for (size_t i = 0; i < info.lines.size(); i++) {
+            const RootMoveInfo& rootMove = info.lines[i];
+            ostringstream line;
+            line << "info depth " << info.depth << " multipv " << (i + 1) << " score " << rootMove.score
+                 << (rootMove.exact ? "" : " upperbound") << " nodes " << info.nodes
+                 << " time " << (long long)(info.seconds * 1000.0)
+                 << " pv " << moveList_(rootMove.pv);
+            send_(line.str());
+        }
+        if (!timeManager)
+            return true;
+        // the time manager only looks at the two best moves
+        SearchInfo best{info.depth, info.lines[0].move, info.lines[0].score,
+                        (info.lines.size() > 1) ? info.lines[1].score : INT_MIN, info.lines[0].pv, info.nodes, info.seconds};
+        return timeManager->continueSearch(best);
+    });
+    searching_ = false;
+    send_("bestmove " + GameDatabase::squareName(result.lines[0].move));
+}
@@ -0,0 +1,101 @@
+//
+//  Frustum.cpp
+//  Othello
+//
+
+#include <cmath>
+#include "Frustum.h"
+
+using namespace std;
+using namespace graphics3d;
+
+
+Frustum::Frustum(const GLfloat clip[16])
+{
+    //    Gribb & Hartmann: each plane is the last row of the matrix plus or minus one of the others
+    for (int p = 0; p < 6; p++)
+    {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.f : -1.f;
+        for (int k = 0; k < 4; k++)
+            planes_[p][k] = clip[4*k + 3] + sign * clip[4*k + row];
+        float norm = sqrtf(planes_[p][0]*planes_[p][0] + planes_[p][1]*planes_[p][1] + planes_[p][2]*planes_[p][2]);
+        for (int k = 0; k < 4; k++)
+            planes_[p][k] /= norm;
+    }
+}
+
+
+Frustum Frustum::fromCurrentMatrices()
+{
+    GLfloat projection[16], modelview[16], clip[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    for (int col = 0; col < 4; col++)
+        for (int row = 0; row < 4; row++)
+        {
+            clip[4*col + row] = 0.f;
+            for (int k = 0; k < 4; k++)
+                clip[4*col + row] += projection[4*k + row] * modelview[4*col + k];
+        }
+    return Frustum(clip);
+}
+
+
+bool Frustum::mayContain(const BoundingSphere& sphere) const
+{
+    for (int p = 0; p < 6; p++)
+    {
+        const float* plane = planes_[p];
+        if (plane[0]*sphere.center[0] + plane[1]*sphere.center[1] + plane[2]*sphere.center[2] + plane[3] < -sphere.radius)
+            return false;
+    }
+    return true;
+}
+
+
+Frustum::Test Frustum::classify(const Bounds3D& box) const
+{
+    Test result = Test::INSIDE;
+    for (int p = 0; p < 6; p++)
+    {
+        const float* plane = planes_[p];
+        //    the corners furthest along & against the plane's normal
+        float farthest = plane[3], nearest = plane[3];
+        for (int k = 0; k < 3; k++)
+        {
+            farthest += plane[k] * ((plane[k] >= 0.f) ? box.max[k] : box.min[k]);
+            nearest += plane[k] * ((plane[k] >= 0.f) ? box.min[k] : box.max[k]);
+        }
+        if (farthest < 0.f)
+            return Test::OUTSIDE;
+        if (nearest < 0.f)
+            result = Test::INTERSECTS;
+    }
+    return result;
+}
+
+
+bool Frustum::mayContain(const GraphicObject3D& object) const
+{
+    const Bounds3D& box = object.getWorldBounds();
+    if (box.isEmpty())
+        return true;
+    return mayContain(object.getWorldSphere()) && (classify(box) != Test::OUTSIDE);
+}
+
+
+void Frustum::cull(const vector<shared_ptr<GraphicObject3D>>& objects,
+                   vector<GraphicObject3D*>& visible, CullStats& stats) const
+{
+    for (const shared_ptr<GraphicObject3D>& object : objects)
+    {
+        if (mayContain(*object))
+        {
+            visible.push_back(object.get());
+            stats.drawn++;
+        }
+        else
+            stats.culled++;
+    }
+}
@@ -0,0 +1,180 @@
+//
+//  GameDatabase.cpp
+//  Othello
+//
+
+#include "GameDatabase.hpp"
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+using namespace std;
+using namespace othello;
+
+
+const int GameDatabase::WTHOR_HEADER_SIZE_ = 16;
+const int GameDatabase::WTHOR_RECORD_SIZE_ = 68;
+const int GameDatabase::WTHOR_RECORDS_PER_CHUNK_ = 4096;
+
+namespace {
+    inline uint16_t readLittleEndian16(const unsigned char* bytes) {
+        return (uint16_t)(bytes[0] | (bytes[1] << 8));
+    }
+}
+
+
+size_t GameDatabase::importFile(const char* filepath) {
+    string path(filepath);
+    string ext = path.size() > 4 ? path.substr(path.size() - 4) : "";
+    if ((ext == ".wtb") || (ext == ".WTB"))
+        return importWthor(filepath);
+    return importMoveList(filepath);
+}
+
+
+size_t GameDatabase::importWthor(const char* filepath) {
+    ifstream file_data(filepath, ios::binary);
+    if (!file_data.is_open()) {
+        cout << "GameDatabase ERROR: Unable to open file " << filepath << "\n";
+        return 0;
+    }
+
+    unsigned char header[WTHOR_HEADER_SIZE_];
+    if (!file_data.read(reinterpret_cast<char*>(header), WTHOR_HEADER_SIZE_)) {
+        cout << "GameDatabase ERROR: " << filepath << " is too short to be a WTHOR file\n";
+        return 0;
+    }
+    // bytes 4-7: number of game records (little endian)
+    uint32_t numRecords = header[4] | (header[5] << 8) | (header[6] << 16) | ((uint32_t)header[7] << 24);
+    // byte 12: board size, 0 and 8 both mean the regular 8x8 board
+    if ((header[12] != 0) && (header[12] != 8)) {
+        cout << "GameDatabase ERROR: " << filepath << " is not an 8x8 game archive\n";
+        return 0;
+    }
+    games_.reserve(games_.size() + numRecords);
+
+    // stream the records in fixed-size chunks rather than loading the whole archive
+    vector<unsigned char> chunk(WTHOR_RECORD_SIZE_ * WTHOR_RECORDS_PER_CHUNK_);
+    size_t numAdded = 0, numTruncated = 0;
+    uint32_t recordsLeft = numRecords;
+    while (recordsLeft > 0) {
+        uint32_t toRead = min<uint32_t>(recordsLeft, WTHOR_RECORDS_PER_CHUNK_);
+        file_data.read(reinterpret_cast<char*>(chunk.data()), (streamsize)toRead * WTHOR_RECORD_SIZE_);
+        uint32_t numRead = (uint32_t)(file_data.gcount() / WTHOR_RECORD_SIZE_);
+        for (uint32_t i = 0; i < numRead; i++) {
+            const unsigned char* record = chunk.data() + i * WTHOR_RECORD_SIZE_;
+            StoredGame game;
+            game.tournamentId = readLittleEndian16(record);
+            game.blackPlayerId = readLittleEndian16(record + 2);
+            game.whitePlayerId = readLittleEndian16(record + 4);
+            game.blackScore = record[6];
+            // record[7] is the theoretical score, which we don't use
+            game.numMoves = 0;
+            for (int m = 0; m < StoredGame::MAX_MOVES; m++) {
+                // moves are stored as 10*row + column, with 0 marking the end of the game
+                int code = record[8 + m];
+                int row = code / 10, col = code % 10;
+                if ((row < 1) || (row > 8) || (col < 1) || (col > 8))
+                    break;
+                game.moves[game.numMoves++] = (uint8_t)BitBoard::squareIndex(TilePoint{col, row});
+            }
+            for (int m = game.numMoves; m < StoredGame::MAX_MOVES; m++)
+                game.moves[m] = StoredGame::NO_MOVE;
+            if (!validate_(game))
+                numTruncated++;
+            games_.push_back(game);
+            numAdded++;
+        }
+        if (numRead < toRead) {
+            cout << "GameDatabase WARNING: " << filepath << " ended after " << numAdded << " of " << numRecords << " games\n";
+            break;
+        }
+        recordsLeft -= numRead;
+    }
+    if (numTruncated > 0)
+        cout << "GameDatabase WARNING: " << numTruncated << " games in " << filepath << " contained illegal moves and were truncated\n";
+    return numAdded;
+}
+
+
+size_t GameDatabase::importMoveList(const char* filepath) {
+    ifstream file_data(filepath);
+    if (!file_data.is_open()) {
+        cout << "GameDatabase ERROR: Unable to open file " << filepath << "\n";
+        return 0;
+    }
+
+    size_t numAdded = 0, numTruncated = 0;
+    string line;
+    StoredGame game;
+    while (getline(file_data, line)) {
+        if (line.empty() || (line[0] == '#'))
+            continue;
+        if (!parseMoveList(line, game))
+            continue;
+        if (!validate_(game))
+            numTruncated++;
+        games_.push_back(game);
+        numAdded++;
+    }
+    if (numTruncated > 0)
+        cout << "GameDatabase WARNING: " << numTruncated << " games in " << filepath << " contained illegal moves and were truncated\n";
+    return numAdded;
+}
+
+
+bool GameDatabase::parseMoveList(const string& line, StoredGame& game) {
+    game.numMoves = 0;
+    game.blackScore = 0;
+    game.tournamentId = game.blackPlayerId = game.whitePlayerId = 0;
+    for (size_t i = 0; (i + 1 < line.size()) && (game.numMoves < StoredGame::MAX_MOVES); i++) {
+        char letter = (char)tolower(line[i]);
+        char digit = line[i + 1];
+        if ((letter >= 'a') && (letter <= 'h') && (digit >= '1') && (digit <= '8')) {
+            game.moves[game.numMoves++] = (uint8_t)BitBoard::squareIndex(TilePoint{letter - 'a' + 1, digit - '0'});
+            i++;
+        }
+        // anything else (spaces, separators, "pa" or "--" passes) is skipped
+    }
+    for (int m = game.numMoves; m < StoredGame::MAX_MOVES; m++)
+        game.moves[m] = StoredGame::NO_MOVE;
+    return game.numMoves > 0;
+}
+
+
+bool GameDatabase::playMove(BitBoard& pos, bool& blackToMove, int sq) {
+    if (pos.play(sq, blackToMove)) {
+        blackToMove = !blackToMove;
+        return true;
+    }
+    if ((pos.legalMoves(blackToMove) == 0) && pos.play(sq, !blackToMove)) {
+        // the side to move passed, so after this move it's their turn again
+        return true;
+    }
+    return false;
+}
+
+
+string GameDatabase::squareName(int sq) {
+    TilePoint pt = BitBoard::squarePoint(sq);
+    string name;
+    name += (char)('a' + pt.x - 1);
+    name += (char)('0' + pt.y);
+    return name;
+}
+
+
+bool GameDatabase::validate_(StoredGame& game) {
+    BitBoard pos = BitBoard::initialPosition();
+    bool blackToMove = true;
+    for (int m = 0; m < game.numMoves; m++) {
+        if (!playMove(pos, blackToMove, game.moves[m])) {
+            for (int k = m; k < game.numMoves; k++)
+                game.moves[k] = StoredGame::NO_MOVE;
+            game.numMoves = (uint8_t)m;
+            return false;
+        }
+    }
+    return true;
+}
+
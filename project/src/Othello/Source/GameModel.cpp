@@ -0,0 +1,94 @@
+//
+//  GameModel.cpp
+//  Othello
+//
+
+#include "GameModel.hpp"
+#include <algorithm>
+
+using namespace std;
+using namespace othello;
+
+
+GameModel::GameModel()
+    :   GameModel(BitBoard{0, 0}, Side::BLACK)
+{
+
+}
+
+GameModel::GameModel(const BitBoard& position, Side toMove)
+    :   position_(position),
+        toMove_(toMove)
+{
+
+}
+
+
+void GameModel::addObserver(GameObserver* observer) {
+    observers_.push_back(observer);
+}
+
+void GameModel::removeObserver(GameObserver* observer) {
+    observers_.erase(remove(observers_.begin(), observers_.end(), observer), observers_.end());
+}
+
+
+bool GameModel::addDisc(int square, Side who) {
+    uint64_t bit = 1ULL << square;
+    if ((position_.occupied() & bit) || (who == Side::NONE))
+        return false;
+    if (who == Side::BLACK)
+        position_.black |= bit;
+    else
+        position_.white |= bit;
+    for (GameObserver* observer : observers_)
+        observer->onDiscAdded(square, who);
+    return true;
+}
+
+
+bool GameModel::place(Side who, int square) {
+    if ((who == Side::NONE) || (position_.occupied() & (1ULL << square)))
+        return false;
+    bool forBlack = (who == Side::BLACK);
+    uint64_t flipped = forBlack ? BitBoard::flips(square, position_.black, position_.white)
+                                : BitBoard::flips(square, position_.white, position_.black);
+    if (flipped == 0)
+        return false;
+    position_.play(square, forBlack);
+    toMove_ = opponentOf(who);
+    history_.push_back(MoveRecord{square, who, flipped});
+    for (GameObserver* observer : observers_)
+        observer->onMovePlayed(history_.back());
+    return true;
+}
+
+
+bool GameModel::pass() {
+    if (legalMoves(toMove_) != 0)
+        return false;
+    history_.push_back(MoveRecord{-1, toMove_, 0});
+    toMove_ = opponentOf(toMove_);
+    for (GameObserver* observer : observers_)
+        observer->onMovePlayed(history_.back());
+    return true;
+}
+
+
+Side GameModel::owner(int square) const {
+    uint64_t bit = 1ULL << square;
+    if (position_.black & bit)
+        return Side::BLACK;
+    if (position_.white & bit)
+        return Side::WHITE;
+    return Side::NONE;
+}
+
+
+int GameModel::discCount(Side who) const {
+    if (who == Side::BLACK)
+        return BitBoard::popCount(position_.black);
+    if (who == Side::WHITE)
+        return BitBoard::popCount(position_.white);
+    return BitBoard::popCount(position_.empties());
+}
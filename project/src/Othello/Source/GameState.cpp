@@ -21,7 +21,26 @@ GameState::GameState(shared_ptr<Player>& playerWhite, shared_ptr<Player>& player
         playerWhite_(playerWhite),
         board_(board)
 {
-    
+    model_.addObserver(this);
+}
+
+GameState::~GameState() {
+    model_.removeObserver(this);
+}
+
+
+Side GameState::sideOf_(shared_ptr<Player>& player) {
+    RGBColor blackColor = playerBlack_->getMyColor();
+    RGBColor whiteColor = playerWhite_->getMyColor();
+    if (player->getMyColor().isEqualTo(blackColor))
+        return Side::BLACK;
+    if (player->getMyColor().isEqualTo(whiteColor))
+        return Side::WHITE;
+    return Side::NONE;
+}
+
+shared_ptr<Player>& GameState::playerFor_(Side side) {
+    return (side == Side::BLACK) ? playerBlack_ : playerWhite_;
 }
 
 void GameState::getFlankingTiles(std::shared_ptr<Tile>& tile, std::shared_ptr<Player>& curPlayer, std::vector<std::vector<std::shared_ptr<Tile>>>& flankedTiles) {
@@ -143,38 +162,11 @@ bool GameState::discIsStable(std::shared_ptr<Tile>& tile) {
 }
 
 void GameState::getPlayableTiles(std::shared_ptr<Player>& forWho, std::vector<std::shared_ptr<Tile>>& movableTiles) {
-    // go over all the board tiles, finding all tiles owned by the opposing player
-    std::vector<std::vector<std::shared_ptr<Tile>>>* boardTiles_ = board_->getBoardTiles();
-    for (int r = 0; r < boardTiles_->size(); r++) {
-        for (int c = 0; c < boardTiles_->at(r).size(); c++) {
-            std::shared_ptr<Tile> currentTile = boardTiles_->at(r)[c];
-            
-            // check if the tile is owned by the opposing player (if it has an opponent's piece on it)
-            if ((currentTile->getPieceOwner() != forWho) && (currentTile->getPieceOwner() != board_->getNullPlayer() ))
-                // A player's playable tiles need to be adjacent to their opponent's tiles (not owned by the current player and not owned by null player).
-            {
-                TilePoint thisTileLoc = currentTile->getPos();
-                
-                // Start by retreiving this opponent tile's neighbors. These are the tiles the current player can theoretically place their tile on
-                board_->getNeighbors(thisTileLoc, movableTiles);
-            }
-        }
+    // the model knows the legal moves, we just hand out the matching tiles
+    for (uint64_t moves = model_.legalMoves(sideOf_(forWho)); moves; moves &= moves - 1) {
+        TilePoint at = BitBoard::squarePoint(BitBoard::lowestSquare(moves));
+        movableTiles.push_back(board_->getBoardTile(at));
     }
-    
-    // Remove all tiles with pieces already placed on them from the movable tile vector
-    movableTiles.erase(std::remove_if(movableTiles.begin(), movableTiles.end(),
-                        [this](const std::shared_ptr<Tile>& tile) {
-                            return tile->getPieceOwner() != board_->getNullPlayer();
-                        }),
-                        movableTiles.end());
-    
-    
-    // Remove all tiles that aren't flanked by the current player from the movable tiles
-    movableTiles.erase(std::remove_if(movableTiles.begin(), movableTiles.end(),
-                        [this, &forWho](std::shared_ptr<Tile>& tile) {
-                            return !tileIsFlanked(tile, forWho);
-                        }),
-                        movableTiles.end());
 }
 
 
@@ -195,79 +187,68 @@ std::shared_ptr<Tile> GameState::computeTileClicked(float ix, float iy, std::vec
 
 
 std::shared_ptr<Disc> GameState::placePiece(std::shared_ptr<Player>& forWho, std::shared_ptr<Tile>& on) {
-    RGBColor BLACK = RGBColor{0, 0, 0};
-    RGBColor WHITE = RGBColor{1, 1, 1};
-    
-    TilePoint tileLoc = on->getPos();
-    std::shared_ptr<Disc> thisDisc = std::make_shared<Disc>(tileLoc, forWho->getMyColor());
-    board_->addPiece(forWho, thisDisc);
-    
-    std::vector<std::vector<std::shared_ptr<Tile>>> flankedTiles;
-    // retreive which tiles are flanked by this new one
-    getFlankingTiles(on, forWho, flankedTiles);
-    
-    // flip all flanked tiles
-    for (auto dir: flankedTiles) {
-        for (unsigned int i = 0; i < dir.size(); i++) {
-            shared_ptr<Tile> tile = dir[i];
-            if (forWho->getMyColor().isEqualTo(BLACK)) {
-                tile->setOwner(playerBlack_);
-                tile->getPiece()->setColorAfter(BLACK, flip_interval_secs_ * (i+1));
-            } else if (forWho->getMyColor().isEqualTo(WHITE)) {
-                tile->setOwner(playerWhite_);
-                tile->getPiece()->setColorAfter(WHITE, flip_interval_secs_ * (i+1));
-            }
-        }
-    }
-    return thisDisc;
+    lastDisc_ = nullptr;
+    model_.place(sideOf_(forWho), BitBoard::squareIndex(on->getPos()));
+    return lastDisc_;
 }
 
 
 unsigned int GameState::placePiece(std::shared_ptr<Player>& forWho, std::shared_ptr<Tile>& on, bool returnInt) {
-    RGBColor BLACK = RGBColor{0, 0, 0};
-    RGBColor WHITE = RGBColor{1, 1, 1};
-    
-    TilePoint tileLoc = on->getPos();
-    std::shared_ptr<Disc> thisDisc = std::make_shared<Disc>(tileLoc, forWho->getMyColor());
-    board_->addPiece(forWho, thisDisc);
-    
-    std::vector<std::vector<std::shared_ptr<Tile>>> flankedTiles;
-    // retreive which tiles are flanked by this new one
-    getFlankingTiles(on, forWho, flankedTiles);
-    
-    // flip all flanked tiles
-    unsigned int num_flipped = 0;
-    for (auto dir: flankedTiles) {
-        for (unsigned int i = 0; i < dir.size(); i++) {
-            shared_ptr<Tile> tile = dir[i];
-            if (forWho->getMyColor().isEqualTo(BLACK)) {
-                tile->setOwner(playerBlack_);
-                tile->getPiece()->setColorAfter(BLACK, flip_interval_secs_ * (i+1));
-            } else if (forWho->getMyColor().isEqualTo(WHITE)) {
-                tile->setOwner(playerWhite_);
-                tile->getPiece()->setColorAfter(WHITE, flip_interval_secs_ * (i+1));
-            }
-            num_flipped++;
-        }
-    }
-    return num_flipped;
+    if (!model_.place(sideOf_(forWho), BitBoard::squareIndex(on->getPos())))
+        return 0;
+    return BitBoard::popCount(model_.getHistory().back().flipped);
 }
 
 
 void GameState::addGamePiece(TilePoint location, shared_ptr<Player>& whose, std::vector<std::shared_ptr<GraphicObject>>& allObjects) {
-    shared_ptr<Disc> thisDisc = make_shared<Disc>(location, whose->getMyColor());
-    board_->addPiece(whose, thisDisc);
-    allObjects.push_back(thisDisc);
+    lastDisc_ = nullptr;
+    model_.addDisc(BitBoard::squareIndex(location), sideOf_(whose));
+    if (lastDisc_)
+        allObjects.push_back(lastDisc_);
 }
 
 
 void GameState::addGamePiece(TilePoint location, shared_ptr<Player>& whose) {
-    shared_ptr<Disc> thisDisc = make_shared<Disc>(location, whose->getMyColor());
-    board_->addPiece(whose, thisDisc);
+    model_.addDisc(BitBoard::squareIndex(location), sideOf_(whose));
     // overloaded definition doesn't append to allObjects
 }
 
 
+void GameState::onDiscAdded(int square, Side who) {
+    TilePoint location = BitBoard::squarePoint(square);
+    shared_ptr<Player>& owner = playerFor_(who);
+    lastDisc_ = make_shared<Disc>(location, owner->getMyColor());
+    board_->addPiece(owner, lastDisc_);
+}
+
+
+void GameState::onMovePlayed(const MoveRecord& move) {
+    if (move.square < 0) // a pass doesn't change the board
+        return;
+    onDiscAdded(move.square, move.who);
+    
+    // a move that comes in before the previous one's flips have played starts from their final colors
+    timeline_.finishAll();
+    
+    // flip all flanked tiles, one after the other going away from the new disc
+    TilePoint placedAt = BitBoard::squarePoint(move.square);
+    shared_ptr<Player>& owner = playerFor_(move.who);
+    RGBColor ownerColor = owner->getMyColor();
+    uint32_t flips = timeline_.beginSequence();
+    for (uint64_t flipped = move.flipped; flipped; flipped &= flipped - 1) {
+        TilePoint at = BitBoard::squarePoint(BitBoard::lowestSquare(flipped));
+        shared_ptr<Tile> tile = board_->getBoardTile(at);
+        tile->setOwner(owner);
+        int distance = std::max(std::abs(at.x - placedAt.x), std::abs(at.y - placedAt.y));
+        weak_ptr<Disc> disc = tile->getPiece();
+        timeline_.schedule(flips, flip_interval_secs_ * distance, [disc, ownerColor]() {
+            if (shared_ptr<Disc> d = disc.lock())
+                d->setColor(ownerColor);
+        });
+    }
+}
+
+
 bool GameState::isCornerTile(std::shared_ptr<Tile>& tile) {
     bool topRight = tile->getCol() == board_->getColsMax() && tile->getRow() == board_->getRowsMin();
     bool topLeft = tile->getCol() == board_->getColsMax() && tile->getRow() == board_->getRowsMax();
@@ -7,6 +7,7 @@
 
 #include "string.h"
 #include "stdlib.h"
+#include <cmath>
 #include "GraphicObject3D.h"
 
 using namespace graphics3d;
@@ -15,9 +16,23 @@ const Motion Motion::NULL_MOTION{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
 
 GraphicObject3D::GraphicObject3D(const Pose& pose, const Motion& motion)
     :    pose_(pose),
-        motion_(motion)
+        motion_(motion),
+        materialId_(0),
+        localBounds_(Bounds3D::empty()),
+        worldBounds_(Bounds3D::empty()),
+        worldSphere_{{0.f, 0.f, 0.f}, 0.f},
+        worldBoundsValid_(false),
+        poseMatrixValid_(false)
 {}
 
+void GraphicObject3D::draw() const
+{
+    glPushMatrix();
+    applyPose();
+    drawShape();
+    glPopMatrix();
+}
+
 void GraphicObject3D::update(float dt)
 {
     pose_.tX += motion_.vX * dt;
@@ -26,12 +41,80 @@ void GraphicObject3D::update(float dt)
     pose_.pitch += motion_.spinX * dt;
     pose_.yaw += motion_.spinY * dt;
     pose_.roll += motion_.spinZ * dt;
+    //    objects at rest keep their bounds
+    if (isMoving())
+    {
+        worldBoundsValid_ = false;
+        poseMatrixValid_ = false;
+    }
+}
+
+void GraphicObject3D::setLocalBounds(const Bounds3D& bounds)
+{
+    localBounds_ = bounds;
+    worldBoundsValid_ = false;
+}
+
+void GraphicObject3D::updateWorldBounds_() const
+{
+    GLfloat rows[12];
+    poseToRows(pose_, rows);
+    worldBounds_ = localBounds_.transformed(rows);
+    //    a rigid transform keeps the local sphere's radius
+    BoundingSphere local = localBounds_.sphere();
+    for (int i = 0; i < 3; i++)
+        worldSphere_.center[i] = rows[4*i]*local.center[0] + rows[4*i+1]*local.center[1] + rows[4*i+2]*local.center[2] + rows[4*i+3];
+    worldSphere_.radius = localBounds_.isEmpty() ? 0.f : local.radius;
+    worldBoundsValid_ = true;
+}
+
+void GraphicObject3D::poseToRows(const Pose& pose, GLfloat rows[12])
+{
+    //    T * Rz(roll) * Ry(yaw) * Rx(pitch), the order of applyPose
+    float cz = cosf(pose.roll * DEG_TO_RAD), sz = sinf(pose.roll * DEG_TO_RAD);
+    float cy = cosf(pose.yaw * DEG_TO_RAD), sy = sinf(pose.yaw * DEG_TO_RAD);
+    float cx = cosf(pose.pitch * DEG_TO_RAD), sx = sinf(pose.pitch * DEG_TO_RAD);
+    
+    rows[0] = cz*cy;    rows[1] = cz*sy*sx - sz*cx;    rows[2] = cz*sy*cx + sz*sx;     rows[3] = pose.tX;
+    rows[4] = sz*cy;    rows[5] = sz*sy*sx + cz*cx;    rows[6] = sz*sy*cx - cz*sx;     rows[7] = pose.tY;
+    rows[8] = -sy;      rows[9] = cy*sx;               rows[10] = cy*cx;               rows[11] = pose.tZ;
+}
+
+void GraphicObject3D::poseToMatrix(const Pose& pose, GLfloat matrix[16])
+{
+    GLfloat rows[12];
+    poseToRows(pose, rows);
+    for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 4; col++)
+            matrix[4*col + row] = rows[4*row + col];
+    matrix[3] = matrix[7] = matrix[11] = 0.f;
+    matrix[15] = 1.f;
+}
+
+Pose GraphicObject3D::matrixToPose(const GLfloat matrix[16])
+{
+    //    the terms of poseToRows: matrix[4*col + row]
+    Pose pose{matrix[12], matrix[13], matrix[14], 0.f, 0.f, 0.f};
+    float cy = sqrtf(matrix[0]*matrix[0] + matrix[1]*matrix[1]);
+    pose.yaw = atan2f(-matrix[2], cy) * RAD_TO_DEG;
+    if (cy > 1e-6f)
+    {
+        pose.roll = atan2f(matrix[1], matrix[0]) * RAD_TO_DEG;
+        pose.pitch = atan2f(matrix[6], matrix[10]) * RAD_TO_DEG;
+    }
+    else
+    {
+        //    yaw at +/-90: roll & pitch turn about the same axis, so it all goes in roll
+        pose.roll = atan2f(-matrix[4], matrix[5]) * RAD_TO_DEG;
+    }
+    return pose;
 }
 
 void GraphicObject3D::setMaterial(const Material& material)
 {
 //    material_.sMaterial = material.sMaterial;
     memcpy(material_.aMaterial, material.aMaterial, 17*sizeof(float));
+    materialId_ = ::materialId(material_);
 }
             
 const Material& GraphicObject3D::getMaterial() const
@@ -0,0 +1,350 @@
+//
+//  InstancedMeshBatch.cpp
+//  Othello
+//
+
+#include <cmath>
+#include <iostream>
+#include "InstancedMeshBatch.h"
+#include "glExtensions.h"
+
+using namespace std;
+using namespace graphics3d;
+
+namespace {
+    //    attribute locations of the instanced shader
+    const GLuint POSITION_ATTRIB = 0;
+    const GLuint NORMAL_ATTRIB = 1;
+    const GLuint MODEL_ROW_ATTRIB = 2;    //    3 consecutive locations
+    const GLuint COLOR_ATTRIB = 5;
+
+    const unsigned int FLOATS_PER_VERTEX = 6;
+    const unsigned int FLOATS_PER_INSTANCE = 16;
+
+    //    Fixed-pipeline lighting (light 0, infinite viewer) with the model matrix of
+    //    each instance taken from its attributes instead of the matrix stack. The
+    //    instance colour stands in for the material's ambient & diffuse, as the
+    //    fallback's glMaterial call does; emission & specular come from the material.
+    const char* VERTEX_SHADER =
+        "#version 120\n"
+        "attribute vec3 position;\n"
+        "attribute vec3 normal;\n"
+        "attribute vec4 modelRow0;\n"
+        "attribute vec4 modelRow1;\n"
+        "attribute vec4 modelRow2;\n"
+        "attribute vec4 color;\n"
+        "varying vec4 litColor;\n"
+        "void main() {\n"
+        "    vec4 p = vec4(position, 1.0);\n"
+        "    vec4 world = vec4(dot(modelRow0, p), dot(modelRow1, p), dot(modelRow2, p), 1.0);\n"
+        "    vec3 n = vec3(dot(modelRow0.xyz, normal), dot(modelRow1.xyz, normal), dot(modelRow2.xyz, normal));\n"
+        "    vec4 eye = gl_ModelViewMatrix * world;\n"
+        "    vec3 N = normalize(gl_NormalMatrix * n);\n"
+        "    vec4 lightPos = gl_LightSource[0].position;\n"
+        "    vec3 L = normalize(lightPos.w == 0.0 ? lightPos.xyz : lightPos.xyz - eye.xyz);\n"
+        "    float diffuse = max(dot(N, L), 0.0);\n"
+        "    vec3 H = normalize(L + vec3(0.0, 0.0, 1.0));\n"
+        "    float specular = (diffuse > 0.0) ? pow(max(dot(N, H), 0.0), gl_FrontMaterial.shininess) : 0.0;\n"
+        "    vec3 light = gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb + diffuse * gl_LightSource[0].diffuse.rgb;\n"
+        "    vec3 lit = gl_FrontMaterial.emission.rgb + color.rgb * light\n"
+        "             + specular * gl_LightSource[0].specular.rgb * gl_FrontMaterial.specular.rgb;\n"
+        "    litColor = vec4(clamp(lit, 0.0, 1.0), color.a);\n"
+        "    gl_Position = gl_ProjectionMatrix * eye;\n"
+        "}\n";
+
+    const char* FRAGMENT_SHADER =
+        "#version 120\n"
+        "varying vec4 litColor;\n"
+        "void main() {\n"
+        "    gl_FragColor = litColor;\n"
+        "}\n";
+
+    GLuint compileShader(const GLExtensions& gl, GLenum type, const char* source)
+    {
+        GLuint shader = gl.createShader(type);
+        gl.shaderSource(shader, 1, &source, nullptr);
+        gl.compileShader(shader);
+        GLint ok = 0;
+        gl.getShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok)
+        {
+            char log[1024];
+            gl.getShaderInfoLog(shader, sizeof(log), nullptr, log);
+            cout << "InstancedMeshBatch ERROR: shader compilation failed, using display lists\n" << log << endl;
+            gl.deleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+}
+
+
+InstancedMeshBatch::InstancedMeshBatch(shared_ptr<const Mesh> mesh, const Pose& pose, const Motion& motion)
+:   GraphicObject3D(pose, motion),
+    mesh_(mesh),
+    instances_(),
+    useInstancing_(true),
+    triangleBuffer_(0),
+    numTriangleVertices_(0),
+    instanceData_(),
+    instanceBuffer_(0),
+    instanceDataValid_(false),
+    displayList_(0),
+    meshBounds_(Bounds3D::fromPoints(mesh->xyz.data(), mesh->numVertices()))
+{
+    
+}
+
+InstancedMeshBatch::~InstancedMeshBatch()
+{
+    if (displayList_ != 0)
+        glDeleteLists(displayList_, 1);
+    if (triangleBuffer_ != 0)
+    {
+        GLuint buffers[2] = {triangleBuffer_, instanceBuffer_};
+        GLExtensions::get().deleteBuffers(2, buffers);
+    }
+}
+
+
+unsigned int InstancedMeshBatch::add(const Pose& pose, const GLfloat color[4])
+{
+    instances_.push_back(MeshInstance{pose, {color[0], color[1], color[2], color[3]}});
+    instanceDataValid_ = false;
+    
+    GLfloat rows[12];
+    poseToRows(pose, rows);
+    Bounds3D bounds = getLocalBounds();
+    bounds.add(meshBounds_.transformed(rows));
+    setLocalBounds(bounds);
+    return size() - 1;
+}
+
+void InstancedMeshBatch::setInstancePose(unsigned int index, const Pose& pose)
+{
+    instances_[index].pose = pose;
+    instanceDataValid_ = false;
+    
+    //    the moved instance may have been the one at the edge: start over
+    Bounds3D bounds = Bounds3D::empty();
+    GLfloat rows[12];
+    for (const MeshInstance& instance : instances_)
+    {
+        poseToRows(instance.pose, rows);
+        bounds.add(meshBounds_.transformed(rows));
+    }
+    setLocalBounds(bounds);
+}
+
+void InstancedMeshBatch::setInstanceColor(unsigned int index, const GLfloat color[4])
+{
+    for (int k = 0; k < 4; k++)
+        instances_[index].color[k] = color[k];
+    instanceDataValid_ = false;
+}
+
+void InstancedMeshBatch::clear()
+{
+    instances_.clear();
+    instanceDataValid_ = false;
+    setLocalBounds(Bounds3D::empty());
+}
+
+
+bool InstancedMeshBatch::instancingAvailable()
+{
+    const GLExtensions& gl = GLExtensions::get();
+    return gl.hasBuffers && gl.hasInstancing && (program_() != 0);
+}
+
+
+void InstancedMeshBatch::drawShape() const
+{
+    if (instances_.empty())
+        return;
+    
+    if (useInstancing_ && instancingAvailable())
+        drawInstanced_();
+    else
+        drawFallback_();
+}
+
+
+void InstancedMeshBatch::drawInstanced_() const
+{
+    const GLExtensions& gl = GLExtensions::get();
+    if (triangleBuffer_ == 0)
+        uploadTriangles_();
+    if (!instanceDataValid_)
+        uploadInstanceData_();
+    
+    //    the shader reads the material's emission & specular from the GL state
+    setCurrentMaterial(getMaterial());
+    gl.useProgram(program_());
+    
+    //    per-vertex attributes (with a buffer bound, the "pointers" are offsets into it)
+    const GLsizei vertexStride = FLOATS_PER_VERTEX * sizeof(GLfloat);
+    gl.bindBuffer(GL_ARRAY_BUFFER, triangleBuffer_);
+    gl.enableVertexAttribArray(POSITION_ATTRIB);
+    gl.vertexAttribPointer(POSITION_ATTRIB, 3, GL_FLOAT, GL_FALSE, vertexStride, nullptr);
+    gl.enableVertexAttribArray(NORMAL_ATTRIB);
+    gl.vertexAttribPointer(NORMAL_ATTRIB, 3, GL_FLOAT, GL_FALSE, vertexStride, reinterpret_cast<const void*>(3 * sizeof(GLfloat)));
+    
+    //    per-instance attributes (advance once per instance rather than once per vertex)
+    const GLsizei instanceStride = FLOATS_PER_INSTANCE * sizeof(GLfloat);
+    gl.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+    for (GLuint k = 0; k < 4; k++)
+    {
+        GLuint attrib = (k < 3) ? MODEL_ROW_ATTRIB + k : COLOR_ATTRIB;
+        gl.enableVertexAttribArray(attrib);
+        gl.vertexAttribPointer(attrib, 4, GL_FLOAT, GL_FALSE, instanceStride, reinterpret_cast<const void*>(4*k * sizeof(GLfloat)));
+        gl.vertexAttribDivisor(attrib, 1);
+    }
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    gl.drawArraysInstanced(GL_TRIANGLES, 0, numTriangleVertices_, (GLsizei) instances_.size());
+    
+    for (GLuint k = 0; k < 4; k++)
+    {
+        GLuint attrib = (k < 3) ? MODEL_ROW_ATTRIB + k : COLOR_ATTRIB;
+        gl.vertexAttribDivisor(attrib, 0);
+        gl.disableVertexAttribArray(attrib);
+    }
+    gl.disableVertexAttribArray(NORMAL_ATTRIB);
+    gl.disableVertexAttribArray(POSITION_ATTRIB);
+    gl.useProgram(0);
+}
+
+
+void InstancedMeshBatch::drawFallback_() const
+{
+    if (displayList_ == 0)
+    {
+        displayList_ = glGenLists(1);
+        glNewList(displayList_, GL_COMPILE);
+            mesh_->draw();
+        glEndList();
+    }
+    
+    setCurrentMaterial(getMaterial());
+    for (const MeshInstance& instance : instances_)
+    {
+        glPushMatrix();
+        applyPose(instance.pose);
+        glMaterialfv(GL_FRONT, GL_AMBIENT_AND_DIFFUSE, instance.color);
+        glCallList(displayList_);
+        glPopMatrix();
+    }
+    //    the instances' colours went around the state cache
+    invalidateRenderState();
+}
+
+
+void InstancedMeshBatch::uploadTriangles_() const
+{
+    const vector<GLfloat>& xyz = mesh_->xyz;
+    const vector<GLfloat>& normals = mesh_->normals;
+    bool hasNormals = !normals.empty();
+    
+    //    de-indexed, since drawArraysInstanced is the only instanced call we load
+    vector<GLfloat> triangles;
+    auto addTriangle = [&](unsigned int a, unsigned int b, unsigned int c)
+    {
+        GLfloat faceNormal[3] = {0.f, 0.f, 1.f};
+        if (!hasNormals)
+        {
+            //    flat shading from the winding, like a face with no normal in the obj file
+            GLfloat u[3], v[3];
+            for (int k = 0; k < 3; k++)
+            {
+                u[k] = xyz[3*b + k] - xyz[3*a + k];
+                v[k] = xyz[3*c + k] - xyz[3*a + k];
+            }
+            faceNormal[0] = u[1]*v[2] - u[2]*v[1];
+            faceNormal[1] = u[2]*v[0] - u[0]*v[2];
+            faceNormal[2] = u[0]*v[1] - u[1]*v[0];
+        }
+        for (unsigned int vertex : {a, b, c})
+        {
+            triangles.insert(triangles.end(), {xyz[3*vertex], xyz[3*vertex + 1], xyz[3*vertex + 2]});
+            if (hasNormals)
+                triangles.insert(triangles.end(), {normals[3*vertex], normals[3*vertex + 1], normals[3*vertex + 2]});
+            else
+                triangles.insert(triangles.end(), faceNormal, faceNormal + 3);
+        }
+    };
+    
+    vector<GLuint> indices = mesh_->triangleIndices();
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        addTriangle(indices[i], indices[i + 1], indices[i + 2]);
+    numTriangleVertices_ = (GLsizei)(triangles.size() / FLOATS_PER_VERTEX);
+    
+    const GLExtensions& gl = GLExtensions::get();
+    GLuint buffers[2];
+    gl.genBuffers(2, buffers);
+    triangleBuffer_ = buffers[0];
+    instanceBuffer_ = buffers[1];
+    gl.bindBuffer(GL_ARRAY_BUFFER, triangleBuffer_);
+    gl.bufferData(GL_ARRAY_BUFFER, triangles.size() * sizeof(GLfloat), triangles.data(), GL_STATIC_DRAW);
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void InstancedMeshBatch::uploadInstanceData_() const
+{
+    instanceData_.resize(instances_.size() * FLOATS_PER_INSTANCE);
+    GLfloat* out = instanceData_.data();
+    for (const MeshInstance& instance : instances_)
+    {
+        poseToRows(instance.pose, out);
+        for (int k = 0; k < 4; k++)
+            out[12 + k] = instance.color[k];
+        out += FLOATS_PER_INSTANCE;
+    }
+    
+    const GLExtensions& gl = GLExtensions::get();
+    gl.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer_);
+    gl.bufferData(GL_ARRAY_BUFFER, instanceData_.size() * sizeof(GLfloat), instanceData_.data(), GL_DYNAMIC_DRAW);
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+    instanceDataValid_ = true;
+}
+
+
+GLuint InstancedMeshBatch::program_()
+{
+    static bool built = false;
+    static GLuint program = 0;
+    if (built)
+        return program;
+    built = true;
+    
+    const GLExtensions& gl = GLExtensions::get();
+    if (!gl.hasShaders)
+        return 0;
+    GLuint vertexShader = compileShader(gl, GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragmentShader = compileShader(gl, GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (vertexShader == 0 || fragmentShader == 0)
+        return 0;
+    
+    GLuint candidate = gl.createProgram();
+    gl.attachShader(candidate, vertexShader);
+    gl.attachShader(candidate, fragmentShader);
+    gl.bindAttribLocation(candidate, POSITION_ATTRIB, "position");
+    gl.bindAttribLocation(candidate, NORMAL_ATTRIB, "normal");
+    gl.bindAttribLocation(candidate, MODEL_ROW_ATTRIB, "modelRow0");
+    gl.bindAttribLocation(candidate, MODEL_ROW_ATTRIB + 1, "modelRow1");
+    gl.bindAttribLocation(candidate, MODEL_ROW_ATTRIB + 2, "modelRow2");
+    gl.bindAttribLocation(candidate, COLOR_ATTRIB, "color");
+    gl.linkProgram(candidate);
+    
+    GLint ok = 0;
+    gl.getProgramiv(candidate, GL_LINK_STATUS, &ok);
+    if (!ok)
+    {
+        char log[1024];
+        gl.getProgramInfoLog(candidate, sizeof(log), nullptr, log);
+        cout << "InstancedMeshBatch ERROR: shader link failed, using display lists\n" << log << endl;
+        return 0;
+    }
+    program = candidate;
+    return program;
+}
@@ -0,0 +1,92 @@
+//
+//  LevelOfDetail.cpp
+//  Othello
+//
+
+#include <cmath>
+#include <limits>
+#include "LevelOfDetail.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const float LevelOfDetail::EDGE_PIXELS = 8.f;
+const float LevelOfDetail::HYSTERESIS = 0.15f;
+
+float LevelOfDetail::pixelScale_ = 0.f;
+GLfloat LevelOfDetail::view_[16] = {1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f};
+bool LevelOfDetail::isPerspective_ = true;
+bool LevelOfDetail::enabled_ = true;
+LodStats LevelOfDetail::frameStats_ = {0, 0};
+
+
+LevelOfDetail::LevelOfDetail()
+:   maxPixels_(),
+    numTriangles_(),
+    current_(0)
+{
+    
+}
+
+
+void LevelOfDetail::addLevel(float stepsAcross, unsigned int numTriangles)
+{
+    //    nothing is too big for the finest level
+    maxPixels_.push_back(maxPixels_.empty() ? numeric_limits<float>::infinity() : stepsAcross * EDGE_PIXELS);
+    numTriangles_.push_back(numTriangles);
+}
+
+
+unsigned int LevelOfDetail::select(const BoundingSphere& worldSphere) const
+{
+    if (maxPixels_.empty())
+        return 0;
+    
+    if (!enabled_ || (pixelScale_ == 0.f))
+        current_ = 0;
+    else
+    {
+        float size = screenSize(worldSphere);
+        //    finer as soon as the current level is too coarse...
+        while ((current_ > 0) && (size > maxPixels_[current_]))
+            current_--;
+        //    ...but coarser only once clearly small enough for the next one
+        while ((current_ + 1 < maxPixels_.size()) && (size < maxPixels_[current_ + 1] * (1.f - HYSTERESIS)))
+            current_++;
+    }
+    frameStats_.trianglesFull += numTriangles_[0];
+    frameStats_.trianglesDrawn += numTriangles_[current_];
+    return current_;
+}
+
+
+void LevelOfDetail::beginFrame()
+{
+    GLfloat projection[16];
+    GLint viewport[4];
+    //    read once here rather than for every object: each glGet is a round trip to the driver
+    glGetFloatv(GL_MODELVIEW_MATRIX, view_);
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    pixelScale_ = projection[5] * 0.5f * viewport[3];
+    //    a perspective projection copies -z into w
+    isPerspective_ = (projection[11] != 0.f);
+    frameStats_ = {0, 0};
+}
+
+
+float LevelOfDetail::screenSize(const BoundingSphere& worldSphere)
+{
+    //    in case the view scales the world
+    float scale = sqrtf(view_[0]*view_[0] + view_[1]*view_[1] + view_[2]*view_[2]);
+    float diameter = 2.f * worldSphere.radius * scale;
+    if (!isPerspective_)
+        return diameter * pixelScale_;
+    
+    const float* c = worldSphere.center;
+    float depth = -(view_[2]*c[0] + view_[6]*c[1] + view_[10]*c[2] + view_[14]);
+    //    the camera is inside (or right against) the sphere
+    if (depth <= 0.5f * diameter)
+        return numeric_limits<float>::infinity();
+    return diameter * pixelScale_ / depth;
+}
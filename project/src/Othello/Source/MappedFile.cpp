@@ -0,0 +1,78 @@
+//
+//  MappedFile.cpp
+//  Othello
+//
+
+#include "MappedFile.h"
+
+#if defined(_MSC_VER)
+    #include <fstream>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace std;
+using namespace graphics3d;
+
+namespace {
+    //    what an empty file points to: open, but with nothing to map
+    const char EMPTY_FILE[1] = {0};
+}
+
+
+MappedFile::MappedFile(const string& path, bool randomAccess)
+:   data_(nullptr),
+    size_(0),
+    mapped_(false)
+{
+#if defined(_MSC_VER)
+    //    no mmap here: read the file into memory instead
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file.is_open())
+        return;
+    size_ = (size_t) file.tellg();
+    char* copy = new char[size_ + 1];
+    file.seekg(0);
+    file.read(copy, size_);
+    data_ = copy;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return;
+    struct stat info;
+    if (fstat(fd, &info) == 0)
+    {
+        size_ = (size_t) info.st_size;
+        if (size_ == 0)
+            data_ = EMPTY_FILE;
+        else
+        {
+            void* view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (view != MAP_FAILED)
+            {
+                madvise(view, size_, randomAccess ? MADV_RANDOM : MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(view);
+                mapped_ = true;
+            }
+            else
+                size_ = 0;
+        }
+    }
+    //    the mapping stays valid once the descriptor is closed
+    close(fd);
+#endif
+}
+
+
+MappedFile::~MappedFile()
+{
+#if defined(_MSC_VER)
+    delete []data_;
+#else
+    if (mapped_)
+        munmap(const_cast<char*>(data_), size_);
+#endif
+}
@@ -0,0 +1,177 @@
+//
+//  Mesh.cpp
+//  Othello
+//
+
+#include "Mesh.h"
+
+using namespace std;
+using namespace graphics3d;
+
+
+void Mesh::draw() const
+{
+    if (MeshBuffer::available())
+    {
+        if (buffer == nullptr)
+        {
+            buffer = make_unique<MeshBuffer>();
+            buffer->upload(xyz, normals, triangleIndices(), GL_STATIC_DRAW);
+        }
+        buffer->draw();
+        return;
+    }
+    
+    bool hasNormals = !normals.empty();
+    if (isIndexed())
+    {
+        glBegin(GL_TRIANGLES);
+            for (const MeshPart& part : parts)
+                for (unsigned int i = part.first; i < part.first + part.count; i++)
+                {
+                    if (hasNormals)
+                        glNormal3fv(&normals[3*indices[i]]);
+                    glVertex3fv(&xyz[3*indices[i]]);
+                }
+        glEnd();
+        return;
+    }
+    for (const MeshPart& part : parts)
+    {
+        glBegin(part.mode);
+            for (unsigned int v = part.first; v < part.first + part.count; v++)
+            {
+                if (hasNormals)
+                    glNormal3fv(&normals[3*v]);
+                glVertex3fv(&xyz[3*v]);
+            }
+        glEnd();
+    }
+}
+
+
+vector<GLuint> Mesh::triangleIndices() const
+{
+    if (isIndexed())
+    {
+        vector<GLuint> triangles;
+        for (const MeshPart& part : parts)
+            triangles.insert(triangles.end(), indices.begin() + part.first, indices.begin() + part.first + part.count);
+        return triangles;
+    }
+    
+    vector<GLuint> triangles;
+    auto addTriangle = [&triangles](GLuint a, GLuint b, GLuint c)
+    {
+        triangles.insert(triangles.end(), {a, b, c});
+    };
+    
+    for (const MeshPart& part : parts)
+    {
+        GLuint first = part.first, count = part.count;
+        switch (part.mode)
+        {
+            case GL_TRIANGLES:
+                for (GLuint i = 0; i + 2 < count; i += 3)
+                    addTriangle(first + i, first + i + 1, first + i + 2);
+                break;
+            
+            case GL_QUADS:
+                for (GLuint i = 0; i + 3 < count; i += 4)
+                {
+                    addTriangle(first + i, first + i + 1, first + i + 2);
+                    addTriangle(first + i, first + i + 2, first + i + 3);
+                }
+                break;
+            
+            case GL_TRIANGLE_STRIP:
+                //    every other triangle of a strip is wound the other way
+                for (GLuint i = 0; i + 2 < count; i++)
+                {
+                    if (i % 2 == 0)
+                        addTriangle(first + i, first + i + 1, first + i + 2);
+                    else
+                        addTriangle(first + i + 1, first + i, first + i + 2);
+                }
+                break;
+            
+            case GL_QUAD_STRIP:
+                for (GLuint i = 0; i + 3 < count; i += 2)
+                {
+                    addTriangle(first + i, first + i + 1, first + i + 3);
+                    addTriangle(first + i, first + i + 3, first + i + 2);
+                }
+                break;
+            
+            case GL_POLYGON:
+            case GL_TRIANGLE_FAN:
+                //    polygons are convex, so a fan from their first vertex covers them
+                for (GLuint i = 1; i + 1 < count; i++)
+                    addTriangle(first, first + i, first + i + 1);
+                break;
+            
+            default:
+                //    points & lines have no surface
+                break;
+        }
+    }
+    return triangles;
+}
+
+
+unsigned int Mesh::numTriangles() const
+{
+    unsigned int count = 0;
+    for (const MeshPart& part : parts)
+    {
+        if (isIndexed())
+        {
+            count += part.count / 3;
+            continue;
+        }
+        switch (part.mode)
+        {
+            case GL_TRIANGLES:
+                count += part.count / 3;
+                break;
+            
+            case GL_QUADS:
+                count += 2 * (part.count / 4);
+                break;
+            
+            case GL_QUAD_STRIP:
+                if (part.count >= 4)
+                    count += 2 * ((part.count - 2) / 2);
+                break;
+            
+            case GL_TRIANGLE_STRIP:
+            case GL_POLYGON:
+            case GL_TRIANGLE_FAN:
+                if (part.count >= 3)
+                    count += part.count - 2;
+                break;
+            
+            default:
+                break;
+        }
+    }
+    return count;
+}
+
+
+Mesh Mesh::fromFaces(const vector<vector<float>>& vertices, const vector<vector<int>>& faces)
+{
+    Mesh mesh;
+    for (const vector<int>& face : faces)
+    {
+        // in obj files faces are polygons (shapes with any number of vertices)
+        mesh.parts.push_back(MeshPart{GL_POLYGON, mesh.numVertices(), (unsigned int)face.size()});
+        for (int index : face)
+        {
+            // when faces are listed in obj files they index starting at 1, but vectors are indexed starting at 0
+            const vector<float>& vertex = vertices[index - 1];
+            mesh.xyz.insert(mesh.xyz.end(), {vertex[0], vertex[1], vertex[2]});
+        }
+    }
+    return mesh;
+}
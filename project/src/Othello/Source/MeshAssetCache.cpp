@@ -0,0 +1,174 @@
+//
+//  MeshAssetCache.cpp
+//  Othello
+//
+
+#include "MeshAssetCache.h"
+#include "BinaryMesh.h"
+#include "MappedFile.h"
+#include "NormalGenerator.h"
+#include "ObjLoader.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace graphics3d;
+
+
+namespace {
+    struct FileEntry
+    {
+        weak_ptr<const Mesh> mesh;
+        uint64_t contentHash;
+        /// Size & modification time when the file was read, to tell whether it needs reading again.
+        off_t size;
+        time_t mtime;
+    };
+
+    /// The registry only holds weak references: a mesh is freed as soon as the last object using it is,
+    /// and the entry is then rebuilt by the next load.
+    struct Registry
+    {
+        mutex lock;
+        unordered_map<string, FileEntry> files;
+        /// Identical files (under different paths) share one mesh.
+        unordered_map<uint64_t, weak_ptr<const Mesh>> contents;
+        unordered_map<string, weak_ptr<const Mesh>> named;
+    };
+
+    atomic<bool> binaryCacheEnabled(true);
+    atomic<bool> optimizationEnabled(true);
+
+    // function-local, so unit shapes built during static initialization find it ready
+    Registry& registry()
+    {
+        static Registry reg;
+        return reg;
+    }
+}
+
+
+shared_ptr<const Mesh> MeshAssetCache::loadObj(const string& path)
+{
+    Registry& reg = registry();
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0)
+        return nullptr;
+    {
+        lock_guard<mutex> guard(reg.lock);
+        auto found = reg.files.find(path);
+        if ((found != reg.files.end()) && (found->second.size == info.st_size) && (found->second.mtime == info.st_mtime))
+        {
+            if (shared_ptr<const Mesh> mesh = found->second.mesh.lock())
+                return mesh;
+        }
+    }
+
+    MappedFile file(path);
+    if (!file.isOpen())
+        return nullptr;
+    uint64_t hash = BinaryMesh::hashBytes(file.begin(), file.end());
+
+    shared_ptr<const Mesh> mesh;
+    {
+        lock_guard<mutex> guard(reg.lock);
+        mesh = reg.contents[hash].lock();
+    }
+    if (!mesh)
+    {
+        //    the binary copy next to the file skips the parse, as long as the file hasn't changed since
+        string cachePath = BinaryMesh::cachePathFor(path);
+        BinaryMesh cached;
+        if (useBinaryCache() && cached.open(cachePath) && cached.isFreshFor(hash, file.size(), optimizeMeshes()))
+            mesh = make_shared<const Mesh>(cached.toMesh());
+        else
+        {
+            mesh = make_shared<const Mesh>(buildObj(file.begin(), file.end()));
+            if (useBinaryCache())
+                BinaryMesh::write(cachePath, *mesh, hash, file.size(), optimizeMeshes());
+        }
+    }
+
+    lock_guard<mutex> guard(reg.lock);
+    // another thread may have loaded the same content meanwhile: keep a single copy
+    if (shared_ptr<const Mesh> other = reg.contents[hash].lock())
+        mesh = other;
+    else
+        reg.contents[hash] = mesh;
+    reg.files[path] = FileEntry{mesh, hash, info.st_size, info.st_mtime};
+    return mesh;
+}
+
+
+Mesh MeshAssetCache::buildObj(const char* begin, const char* end, MeshOptimizerReport* report)
+{
+    Mesh mesh = ObjLoader::toMesh(ObjLoader::parse(begin, end));
+    //    computed here once (and saved with the binary copy) rather than flat-shaded at draw time
+    if (mesh.normals.empty())
+        NormalGenerator::computeNormals(mesh);
+    //    (after the normals, so that welding keeps their creases)
+    if (optimizeMeshes())
+    {
+        MeshOptimizerReport done = MeshOptimizer::optimize(mesh);
+        if (report != nullptr)
+            *report = done;
+    }
+    return mesh;
+}
+
+
+shared_ptr<const Mesh> MeshAssetCache::getOrBuild(const string& name, const function<Mesh()>& build)
+{
+    Registry& reg = registry();
+    {
+        lock_guard<mutex> guard(reg.lock);
+        if (shared_ptr<const Mesh> mesh = reg.named[name].lock())
+            return mesh;
+    }
+    shared_ptr<const Mesh> mesh = make_shared<const Mesh>(build());
+    lock_guard<mutex> guard(reg.lock);
+    if (shared_ptr<const Mesh> other = reg.named[name].lock())
+        return other;
+    reg.named[name] = mesh;
+    return mesh;
+}
+
+
+size_t MeshAssetCache::numLiveMeshes()
+{
+    Registry& reg = registry();
+    lock_guard<mutex> guard(reg.lock);
+    size_t numLive = 0;
+    for (auto& entry : reg.contents)
+        numLive += entry.second.expired() ? 0 : 1;
+    for (auto& entry : reg.named)
+        numLive += entry.second.expired() ? 0 : 1;
+    return numLive;
+}
+
+
+
+bool MeshAssetCache::useBinaryCache()
+{
+    return binaryCacheEnabled;
+}
+
+
+void MeshAssetCache::setUseBinaryCache(bool useBinaryCache)
+{
+    binaryCacheEnabled = useBinaryCache;
+}
+
+
+bool MeshAssetCache::optimizeMeshes()
+{
+    return optimizationEnabled;
+}
+
+
+void MeshAssetCache::setOptimizeMeshes(bool optimizeMeshes)
+{
+    optimizationEnabled = optimizeMeshes;
+}
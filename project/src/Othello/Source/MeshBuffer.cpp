@@ -0,0 +1,127 @@
+//
+//  MeshBuffer.cpp
+//  Othello
+//
+
+#include "MeshBuffer.h"
+#include "glExtensions.h"
+
+using namespace std;
+using namespace graphics3d;
+
+
+MeshBuffer::MeshBuffer()
+:   vertexBuffer_(0),
+    indexBuffer_(0),
+    numVertices_(0),
+    numIndices_(0),
+    hasNormals_(false),
+    staging_()
+{
+    
+}
+
+MeshBuffer::~MeshBuffer()
+{
+    if (isUploaded())
+    {
+        GLuint buffers[2] = {vertexBuffer_, indexBuffer_};
+        GLExtensions::get().deleteBuffers(2, buffers);
+    }
+}
+
+
+bool MeshBuffer::available()
+{
+    return GLExtensions::get().hasBuffers;
+}
+
+
+void MeshBuffer::interleave_(const GLfloat* xyz, const GLfloat* normals, unsigned int numVertices)
+{
+    numVertices_ = numVertices;
+    hasNormals_ = (normals != nullptr);
+    if (!hasNormals_)
+    {
+        staging_.assign(xyz, xyz + 3 * numVertices_);
+        return;
+    }
+    staging_.resize(6 * numVertices_);
+    for (unsigned int v = 0; v < numVertices_; v++)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            staging_[6*v + k] = xyz[3*v + k];
+            staging_[6*v + 3 + k] = normals[3*v + k];
+        }
+    }
+}
+
+
+void MeshBuffer::upload(const GLfloat* xyz, const GLfloat* normals, unsigned int numVertices,
+                        const GLuint* indices, size_t numIndices, GLenum usage)
+{
+    const GLExtensions& gl = GLExtensions::get();
+    if (!isUploaded())
+    {
+        GLuint buffers[2];
+        gl.genBuffers(2, buffers);
+        vertexBuffer_ = buffers[0];
+        indexBuffer_ = buffers[1];
+    }
+    
+    interleave_(xyz, normals, numVertices);
+    gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+    gl.bufferData(GL_ARRAY_BUFFER, staging_.size() * sizeof(GLfloat), staging_.data(), usage);
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+    
+    numIndices_ = (GLsizei) numIndices;
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
+    gl.bufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), indices, GL_STATIC_DRAW);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+
+void MeshBuffer::updateVertices(const GLfloat* xyz, const GLfloat* normals)
+{
+    const GLExtensions& gl = GLExtensions::get();
+    if (hasNormals_)
+    {
+        interleave_(xyz, normals, numVertices_);
+        gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+        gl.bufferSubData(GL_ARRAY_BUFFER, 0, staging_.size() * sizeof(GLfloat), staging_.data());
+    }
+    else
+    {
+        //    positions only: already laid out the way the buffer is
+        gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+        gl.bufferSubData(GL_ARRAY_BUFFER, 0, 3 * numVertices_ * sizeof(GLfloat), xyz);
+    }
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+void MeshBuffer::draw(size_t firstIndex, GLsizei numIndices) const
+{
+    const GLExtensions& gl = GLExtensions::get();
+    const GLsizei stride = (hasNormals_ ? 6 : 3) * sizeof(GLfloat);
+    
+    //    with a buffer bound, the array "pointers" are offsets into it
+    gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, nullptr);
+    if (hasNormals_)
+    {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, stride, reinterpret_cast<const void*>(3 * sizeof(GLfloat)));
+    }
+    
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
+    glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, reinterpret_cast<const void*>(firstIndex * sizeof(GLuint)));
+    
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    if (hasNormals_)
+        glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+}
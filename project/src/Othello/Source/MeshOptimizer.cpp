@@ -0,0 +1,323 @@
+//
+//  MeshOptimizer.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <numeric>
+#include "MeshOptimizer.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const float MeshOptimizer::DEFAULT_WELD_TOLERANCE = 1e-5f;
+const float MeshOptimizer::NORMAL_WELD_TOLERANCE = 1e-3f;
+const unsigned int MeshOptimizer::FORSYTH_CACHE_SIZE = 32;
+const unsigned int MeshOptimizer::ACMR_CACHE_SIZE = 16;
+
+
+namespace {
+    const GLuint NO_VERTEX = UINT_MAX;
+    const unsigned int NO_TRIANGLE = UINT_MAX;
+    
+    //    Forsyth's tuning: how much being in the cache is worth, and how much a vertex with
+    //    few triangles left gets pushed (to finish it off rather than leave lone triangles behind)
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+    
+    float vertexScore(int cachePosition, unsigned int numTrianglesLeft)
+    {
+        if (numTrianglesLeft == 0)
+            return -1.f;
+        float score = 0.f;
+        if (cachePosition >= 0)
+        {
+            //    the last triangle's vertices all get the same score: which one goes first doesn't matter
+            if (cachePosition < 3)
+                score = LAST_TRIANGLE_SCORE;
+            else
+                score = powf(1.f - (cachePosition - 3) / float(MeshOptimizer::FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        return score + VALENCE_BOOST_SCALE * powf((float) numTrianglesLeft, -VALENCE_BOOST_POWER);
+    }
+}
+
+
+MeshOptimizerReport MeshOptimizer::optimize(Mesh& mesh, float weldTolerance)
+{
+    MeshOptimizerReport report;
+    report.verticesBefore = mesh.numVertices();
+    toIndexedTriangles(mesh);
+    report.acmrBefore = acmr(mesh.indices);
+    
+    weldVertices(mesh, weldTolerance);
+    //    one list, so that triangles can move anywhere in it
+    mesh.parts.assign(1, MeshPart{GL_TRIANGLES, 0, (unsigned int) mesh.indices.size()});
+    reorderTriangles(mesh.indices, mesh.numVertices());
+    reorderVertices(mesh);
+    if (mesh.indices.empty())
+        mesh.parts.clear();
+    //    drawn from scratch next time
+    mesh.buffer.reset();
+    
+    report.verticesAfter = mesh.numVertices();
+    report.numTriangles = (unsigned int)(mesh.indices.size() / 3);
+    report.acmrAfter = acmr(mesh.indices);
+    return report;
+}
+
+
+void MeshOptimizer::toIndexedTriangles(Mesh& mesh)
+{
+    if (mesh.isIndexed())
+        return;
+    vector<MeshPart> parts;
+    vector<GLuint> indices;
+    for (const MeshPart& part : mesh.parts)
+    {
+        //    triangulated one part at a time, to keep each part's range
+        Mesh single;
+        single.parts.push_back(part);
+        vector<GLuint> triangles = single.triangleIndices();
+        if (triangles.empty())
+            continue;
+        parts.push_back(MeshPart{GL_TRIANGLES, (unsigned int) indices.size(), (unsigned int) triangles.size()});
+        indices.insert(indices.end(), triangles.begin(), triangles.end());
+    }
+    mesh.parts = parts;
+    mesh.indices = indices;
+}
+
+
+void MeshOptimizer::weldVertices(Mesh& mesh, float tolerance)
+{
+    const unsigned int numVertices = mesh.numVertices();
+    const bool hasNormals = !mesh.normals.empty();
+    if (numVertices == 0)
+        return;
+    
+    //    snap the positions to a grid of tolerance-sized cells & sort by cell:
+    //    vertices that can be welded end up next to each other
+    vector<int64_t> cells(3 * (size_t) numVertices);
+    for (size_t i = 0; i < mesh.xyz.size(); i++)
+        cells[i] = llroundf(mesh.xyz[i] / tolerance);
+    vector<GLuint> order(numVertices);
+    iota(order.begin(), order.end(), 0);
+    sort(order.begin(), order.end(), [&cells](GLuint a, GLuint b)
+         {
+             return lexicographical_compare(&cells[3*a], &cells[3*a] + 3, &cells[3*b], &cells[3*b] + 3);
+         });
+    
+    auto sameNormal = [&mesh](GLuint a, GLuint b)
+    {
+        for (int k = 0; k < 3; k++)
+            if (fabsf(mesh.normals[3*a + k] - mesh.normals[3*b + k]) > NORMAL_WELD_TOLERANCE)
+                return false;
+        return true;
+    };
+    
+    //    each vertex goes to the first one of its cell with the same normal (few per cell: a plain search)
+    vector<GLuint> weldedTo(numVertices, NO_VERTEX);
+    for (size_t start = 0; start < order.size(); )
+    {
+        size_t end = start + 1;
+        while ((end < order.size()) && equal(&cells[3*order[start]], &cells[3*order[start]] + 3, &cells[3*order[end]]))
+            end++;
+        for (size_t i = start; i < end; i++)
+        {
+            GLuint a = order[i];
+            if (weldedTo[a] != NO_VERTEX)
+                continue;
+            weldedTo[a] = a;
+            for (size_t j = i + 1; j < end; j++)
+            {
+                GLuint b = order[j];
+                if ((weldedTo[b] == NO_VERTEX) && (!hasNormals || sameNormal(a, b)))
+                    weldedTo[b] = a;
+            }
+        }
+        start = end;
+    }
+    
+    //    keep the vertices that stay, in their order
+    vector<GLuint> newIndex(numVertices, NO_VERTEX);
+    vector<GLfloat> xyz, normals;
+    for (GLuint v = 0; v < numVertices; v++)
+    {
+        if (weldedTo[v] != v)
+            continue;
+        newIndex[v] = (GLuint)(xyz.size() / 3);
+        xyz.insert(xyz.end(), &mesh.xyz[3*v], &mesh.xyz[3*v] + 3);
+        if (hasNormals)
+            normals.insert(normals.end(), &mesh.normals[3*v], &mesh.normals[3*v] + 3);
+    }
+    
+    vector<GLuint> indices;
+    vector<MeshPart> parts;
+    for (const MeshPart& part : mesh.parts)
+    {
+        unsigned int first = (unsigned int) indices.size();
+        for (unsigned int i = part.first; i + 2 < part.first + part.count; i += 3)
+        {
+            GLuint a = newIndex[weldedTo[mesh.indices[i]]];
+            GLuint b = newIndex[weldedTo[mesh.indices[i + 1]]];
+            GLuint c = newIndex[weldedTo[mesh.indices[i + 2]]];
+            //    a triangle whose corners merged has no surface left
+            if ((a != b) && (b != c) && (a != c))
+                indices.insert(indices.end(), {a, b, c});
+        }
+        if (indices.size() > first)
+            parts.push_back(MeshPart{GL_TRIANGLES, first, (unsigned int) indices.size() - first});
+    }
+    mesh.xyz.swap(xyz);
+    mesh.normals.swap(normals);
+    mesh.indices.swap(indices);
+    mesh.parts.swap(parts);
+}
+
+
+void MeshOptimizer::reorderTriangles(vector<GLuint>& indices, unsigned int numVertices)
+{
+    const unsigned int numTriangles = (unsigned int)(indices.size() / 3);
+    if (numTriangles == 0)
+        return;
+    
+    //    the triangles around each vertex: the first numLeft[v] of them, from offsets[v], are still to be drawn
+    vector<unsigned int> numLeft(numVertices, 0);
+    for (unsigned int i = 0; i < 3 * numTriangles; i++)
+        numLeft[indices[i]]++;
+    vector<unsigned int> offsets(numVertices + 1, 0);
+    for (unsigned int v = 0; v < numVertices; v++)
+        offsets[v + 1] = offsets[v] + numLeft[v];
+    vector<unsigned int> adjacency(offsets[numVertices]);
+    {
+        vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (unsigned int i = 0; i < 3 * numTriangles; i++)
+            adjacency[fill[indices[i]]++] = i / 3;
+    }
+    
+    vector<int> cachePosition(numVertices, -1);
+    vector<float> score(numVertices);
+    for (unsigned int v = 0; v < numVertices; v++)
+        score[v] = vertexScore(-1, numLeft[v]);
+    vector<float> triangleScore(numTriangles);
+    for (unsigned int t = 0; t < numTriangles; t++)
+        triangleScore[t] = score[indices[3*t]] + score[indices[3*t + 1]] + score[indices[3*t + 2]];
+    vector<bool> drawn(numTriangles, false);
+    
+    vector<GLuint> result;
+    result.reserve(indices.size());
+    vector<GLuint> cache, newCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    newCache.reserve(FORSYTH_CACHE_SIZE + 3);
+    unsigned int best = (unsigned int)(max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+    unsigned int nextUndrawn = 0;
+    
+    for (unsigned int n = 0; n < numTriangles; n++)
+    {
+        //    nothing in the cache has triangles left: start a new patch anywhere
+        if (best == NO_TRIANGLE)
+        {
+            while (drawn[nextUndrawn])
+                nextUndrawn++;
+            best = nextUndrawn;
+        }
+        drawn[best] = true;
+        const GLuint* corners = &indices[3*best];
+        result.insert(result.end(), corners, corners + 3);
+        
+        for (int k = 0; k < 3; k++)
+        {
+            GLuint v = corners[k];
+            unsigned int* around = &adjacency[offsets[v]];
+            unsigned int last = --numLeft[v];
+            for (unsigned int i = 0; i <= last; i++)
+                if (around[i] == best)
+                {
+                    swap(around[i], around[last]);
+                    break;
+                }
+        }
+        
+        //    the triangle's vertices move to the front of the cache, pushing the others back
+        newCache.assign(corners, corners + 3);
+        for (GLuint v : cache)
+            if ((v != corners[0]) && (v != corners[1]) && (v != corners[2]))
+                newCache.push_back(v);
+        for (unsigned int i = 0; i < newCache.size(); i++)
+        {
+            GLuint v = newCache[i];
+            cachePosition[v] = (i < FORSYTH_CACHE_SIZE) ? (int) i : -1;
+            float newScore = vertexScore(cachePosition[v], numLeft[v]);
+            float change = newScore - score[v];
+            score[v] = newScore;
+            for (unsigned int a = offsets[v]; a < offsets[v] + numLeft[v]; a++)
+                triangleScore[adjacency[a]] += change;
+        }
+        if (newCache.size() > FORSYTH_CACHE_SIZE)
+            newCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(newCache);
+        
+        //    next: the best triangle using a vertex in the cache
+        best = NO_TRIANGLE;
+        float bestScore = -1.f;
+        for (GLuint v : cache)
+            for (unsigned int a = offsets[v]; a < offsets[v] + numLeft[v]; a++)
+                if (triangleScore[adjacency[a]] > bestScore)
+                {
+                    bestScore = triangleScore[adjacency[a]];
+                    best = adjacency[a];
+                }
+    }
+    indices.swap(result);
+}
+
+
+void MeshOptimizer::reorderVertices(Mesh& mesh)
+{
+    const unsigned int numVertices = mesh.numVertices();
+    const bool hasNormals = !mesh.normals.empty();
+    vector<GLuint> newIndex(numVertices, NO_VERTEX);
+    vector<GLfloat> xyz, normals;
+    xyz.reserve(mesh.xyz.size());
+    normals.reserve(mesh.normals.size());
+    for (GLuint& index : mesh.indices)
+    {
+        GLuint v = index;
+        if (newIndex[v] == NO_VERTEX)
+        {
+            newIndex[v] = (GLuint)(xyz.size() / 3);
+            xyz.insert(xyz.end(), &mesh.xyz[3*v], &mesh.xyz[3*v] + 3);
+            if (hasNormals)
+                normals.insert(normals.end(), &mesh.normals[3*v], &mesh.normals[3*v] + 3);
+        }
+        index = newIndex[v];
+    }
+    mesh.xyz.swap(xyz);
+    mesh.normals.swap(normals);
+}
+
+
+float MeshOptimizer::acmr(const vector<GLuint>& indices, unsigned int cacheSize)
+{
+    if (indices.size() < 3)
+        return 0.f;
+    GLuint numVertices = *max_element(indices.begin(), indices.end()) + 1;
+    //    a vertex is in the FIFO if fewer than cacheSize others came in after it
+    vector<unsigned int> enteredAt(numVertices, 0);
+    unsigned int time = cacheSize;
+    unsigned int misses = 0;
+    for (GLuint v : indices)
+    {
+        if (enteredAt[v] + cacheSize <= time)
+        {
+            enteredAt[v] = time++;
+            misses++;
+        }
+    }
+    return (float) misses / (indices.size() / 3);
+}
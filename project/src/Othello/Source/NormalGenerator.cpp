@@ -0,0 +1,252 @@
+//
+//  NormalGenerator.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "NormalGenerator.h"
+#include "common.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const float NormalGenerator::DEFAULT_CREASE_ANGLE = 45.f;
+const unsigned int NormalGenerator::PARALLEL_THRESHOLD = 50000;
+
+namespace {
+    inline void subtract(const GLfloat* a, const GLfloat* b, float out[3])
+    {
+        out[0] = a[0] - b[0];
+        out[1] = a[1] - b[1];
+        out[2] = a[2] - b[2];
+    }
+
+    inline void cross(const float u[3], const float v[3], float out[3])
+    {
+        out[0] = u[1]*v[2] - u[2]*v[1];
+        out[1] = u[2]*v[0] - u[0]*v[2];
+        out[2] = u[0]*v[1] - u[1]*v[0];
+    }
+
+    inline float dot(const float u[3], const float v[3])
+    {
+        return u[0]*v[0] + u[1]*v[1] + u[2]*v[2];
+    }
+
+    inline void normalize(float v[3])
+    {
+        float norm = sqrtf(dot(v, v));
+        if (norm > 0.f)
+        {
+            v[0] /= norm;
+            v[1] /= norm;
+            v[2] /= norm;
+        }
+        else
+        {
+            v[0] = 0.f;
+            v[1] = 0.f;
+            v[2] = 1.f;
+        }
+    }
+
+    /// Adds the contribution of triangle (p0, p1, p2) to the normal of its corner p0.
+    inline void addCorner(const GLfloat* p0, const GLfloat* p1, const GLfloat* p2, NormalWeighting weighting, float sum[3])
+    {
+        float u[3], v[3], n[3];
+        subtract(p1, p0, u);
+        subtract(p2, p0, v);
+        cross(u, v, n);
+        //    |n| is twice the area, so n itself is the area-weighted normal
+        if (weighting == NormalWeighting::ANGLE)
+        {
+            float length = sqrtf(dot(n, n));
+            if (length == 0.f)
+                return;
+            float angle = atan2f(length, dot(u, v));
+            for (int k = 0; k < 3; k++)
+                n[k] *= angle / length;
+        }
+        for (int k = 0; k < 3; k++)
+            sum[k] += n[k];
+    }
+
+    /// Runs work(begin, end) over [0, count), split across the cores if count is large enough.
+    template <typename Work>
+    void parallelFor(unsigned int count, const Work& work)
+    {
+        unsigned int numThreads = 1;
+        if (count >= NormalGenerator::PARALLEL_THRESHOLD)
+            numThreads = max(1u, thread::hardware_concurrency());
+        
+        vector<thread> workers;
+        unsigned int slice = (count + numThreads - 1) / numThreads;
+        for (unsigned int t = 1; t < numThreads; t++)
+        {
+            unsigned int begin = min(count, t * slice), end = min(count, begin + slice);
+            if (begin < end)
+                workers.emplace_back([&work, begin, end]() { work(begin, end); });
+        }
+        work(0, min(count, slice));
+        for (thread& worker : workers)
+            worker.join();
+    }
+
+    /// The normal of grid vertex (row, col) from the (up to 6) triangles around it.
+    void gridNormal(const VertexGrid& grid, unsigned int row, unsigned int col, NormalWeighting weighting, GLfloat* normal)
+    {
+        float sum[3] = {0.f, 0.f, 0.f};
+        //    the 4 cells that have (row, col) as a corner; each is split into
+        //    (BL, BR, TL) and (BR, TR, TL), counterclockwise seen from +Z
+        for (unsigned int ci = (row > 0 ? row - 1 : 0); (ci <= row) && (ci + 1 < grid.numRows()); ci++)
+        {
+            for (unsigned int cj = (col > 0 ? col - 1 : 0); (cj <= col) && (cj + 1 < grid.numCols()); cj++)
+            {
+                const GLfloat* bl = grid.position(ci, cj);
+                const GLfloat* br = grid.position(ci, cj + 1);
+                const GLfloat* tl = grid.position(ci + 1, cj);
+                const GLfloat* tr = grid.position(ci + 1, cj + 1);
+                bool isBottom = (ci == row), isLeft = (cj == col);
+                if (isBottom && isLeft)
+                    addCorner(bl, br, tl, weighting, sum);
+                else if (isBottom)
+                {
+                    addCorner(br, tl, bl, weighting, sum);
+                    addCorner(br, tr, tl, weighting, sum);
+                }
+                else if (isLeft)
+                {
+                    addCorner(tl, bl, br, weighting, sum);
+                    addCorner(tl, br, tr, weighting, sum);
+                }
+                else
+                    addCorner(tr, tl, br, weighting, sum);
+            }
+        }
+        normalize(sum);
+        normal[0] = sum[0];
+        normal[1] = sum[1];
+        normal[2] = sum[2];
+    }
+}
+
+
+void NormalGenerator::computeNormals(Mesh& mesh, float creaseAngle, NormalWeighting weighting)
+{
+    const unsigned int numVertices = mesh.numVertices();
+    const vector<GLuint> triangles = mesh.triangleIndices();
+    const unsigned int numTriangles = (unsigned int)(triangles.size() / 3);
+    const GLfloat* xyz = mesh.xyz.data();
+    
+    //    unit normal of each triangle, and how much it counts at each of its corners
+    vector<float> faceNormals(3 * numTriangles);
+    vector<float> cornerWeights(3 * numTriangles);
+    parallelFor(numTriangles, [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int t = begin; t < end; t++)
+        {
+            const GLuint* corner = &triangles[3*t];
+            for (int k = 0; k < 3; k++)
+            {
+                float n[3] = {0.f, 0.f, 0.f};
+                addCorner(xyz + 3*corner[k], xyz + 3*corner[(k+1) % 3], xyz + 3*corner[(k+2) % 3], weighting, n);
+                cornerWeights[3*t + k] = sqrtf(dot(n, n));
+                if (k == 0)
+                {
+                    normalize(n);
+                    copy(n, n + 3, &faceNormals[3*t]);
+                }
+            }
+        }
+    });
+    
+    //    the corners of each vertex (a polygon's first vertex is in several triangles of its fan), as offsets into one array
+    vector<unsigned int> cornerStart(numVertices + 1, 0);
+    for (GLuint v : triangles)
+        cornerStart[v + 1]++;
+    for (unsigned int v = 0; v < numVertices; v++)
+        cornerStart[v + 1] += cornerStart[v];
+    vector<unsigned int> corners(triangles.size());
+    {
+        vector<unsigned int> fill(cornerStart.begin(), cornerStart.end() - 1);
+        for (unsigned int c = 0; c < triangles.size(); c++)
+            corners[fill[triangles[c]]++] = c;
+    }
+    
+    //    vertices at the same position (a mesh built face by face repeats them): sort, then take runs
+    vector<unsigned int> byPosition(numVertices);
+    for (unsigned int v = 0; v < numVertices; v++)
+        byPosition[v] = v;
+    sort(byPosition.begin(), byPosition.end(), [xyz](unsigned int a, unsigned int b)
+    {
+        return lexicographical_compare(xyz + 3*a, xyz + 3*a + 3, xyz + 3*b, xyz + 3*b + 3);
+    });
+    vector<unsigned int> runStart(numVertices), runEnd(numVertices);
+    for (unsigned int i = 0; i < numVertices; )
+    {
+        unsigned int j = i + 1;
+        while ((j < numVertices) && equal(xyz + 3*byPosition[i], xyz + 3*byPosition[i] + 3, xyz + 3*byPosition[j]))
+            j++;
+        for (unsigned int k = i; k < j; k++)
+        {
+            runStart[byPosition[k]] = i;
+            runEnd[byPosition[k]] = j;
+        }
+        i = j;
+    }
+    
+    //    each vertex: the faces around its position that aren't across a crease from its own face
+    const float minCosine = cosf(creaseAngle * static_cast<float>(DEG_TO_RAD));
+    mesh.normals.assign(3 * numVertices, 0.f);
+    parallelFor(numVertices, [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int v = begin; v < end; v++)
+        {
+            float sum[3] = {0.f, 0.f, 0.f};
+            if (cornerStart[v] < cornerStart[v + 1])
+            {
+                const float* ownFace = &faceNormals[3 * (corners[cornerStart[v]] / 3)];
+                for (unsigned int k = runStart[v]; k < runEnd[v]; k++)
+                {
+                    unsigned int other = byPosition[k];
+                    for (unsigned int c = cornerStart[other]; c < cornerStart[other + 1]; c++)
+                    {
+                        const float* face = &faceNormals[3 * (corners[c] / 3)];
+                        if (dot(ownFace, face) < minCosine)
+                            continue;
+                        for (int i = 0; i < 3; i++)
+                            sum[i] += cornerWeights[corners[c]] * face[i];
+                    }
+                }
+            }
+            normalize(sum);
+            copy(sum, sum + 3, &mesh.normals[3*v]);
+        }
+    });
+}
+
+
+void NormalGenerator::computeGridNormals(VertexGrid& grid, NormalWeighting weighting)
+{
+    parallelFor(grid.numVertices(), [&](unsigned int begin, unsigned int end)
+    {
+        for (unsigned int v = begin; v < end; v++)
+        {
+            unsigned int row = v / grid.numCols(), col = v % grid.numCols();
+            gridNormal(grid, row, col, weighting, grid.normal(row, col));
+        }
+    });
+}
+
+
+void NormalGenerator::updateGridNormals(VertexGrid& grid, unsigned int row, unsigned int col, NormalWeighting weighting)
+{
+    //    the triangles that moved are those around (row, col), so only their corners' normals change
+    unsigned int lastRow = min(row + 1, grid.numRows() - 1), lastCol = min(col + 1, grid.numCols() - 1);
+    for (unsigned int i = (row > 0 ? row - 1 : 0); i <= lastRow; i++)
+        for (unsigned int j = (col > 0 ? col - 1 : 0); j <= lastCol; j++)
+            gridNormal(grid, i, j, weighting, grid.normal(i, j));
+}
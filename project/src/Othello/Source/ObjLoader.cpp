@@ -0,0 +1,321 @@
+//
+//  ObjLoader.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include "ObjLoader.h"
+#include "MappedFile.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const size_t ObjLoader::PARALLEL_THRESHOLD = 4 << 20;
+
+namespace {
+    /// Don't bother giving a thread less text than this.
+    const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+    //    bits of ChunkResult::relative: which indices of a corner were negative in the file
+    const uint8_t RELATIVE_POSITION = 1;
+    const uint8_t RELATIVE_TEXCOORD = 2;
+    const uint8_t RELATIVE_NORMAL = 4;
+
+    /// What one thread makes of its chunk. Everything is numbered from the start of the chunk,
+    /// until merge() shifts it by what the previous chunks contain.
+    struct ChunkResult
+    {
+        ObjData data;
+        /// Per corner, the RELATIVE_* bits. A relative index was stored as (vertices seen in this chunk + index),
+        /// so it may be negative until the chunk is placed after the previous ones.
+        vector<uint8_t> relative;
+    };
+
+    inline const char* skipBlanks(const char* p, const char* end)
+    {
+        while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+            p++;
+        return p;
+    }
+
+    inline bool parseFloat(const char*& p, const char* end, float& value)
+    {
+        p = skipBlanks(p, end);
+        if ((p < end) && (*p == '+'))    //    from_chars doesn't take a '+'
+            p++;
+        from_chars_result result = from_chars(p, end, value);
+        if (result.ec != errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    inline bool parseInt(const char*& p, const char* end, int& value)
+    {
+        if ((p < end) && (*p == '+'))
+            p++;
+        from_chars_result result = from_chars(p, end, value);
+        if (result.ec != errc())
+            return false;
+        p = result.ptr;
+        return true;
+    }
+
+    /// Turns an OBJ index (1 = first, -1 = last so far, 0 = invalid) into one from 0.
+    /// @return false for index 0.
+    inline bool resolveIndex(int index, unsigned int numSoFar, int& resolved, bool& isRelative)
+    {
+        if (index == 0)
+            return false;
+        isRelative = (index < 0);
+        resolved = isRelative ? (int) numSoFar + index : index - 1;
+        return true;
+    }
+
+    void parseFace(const char* p, const char* end, ChunkResult& chunk,
+                   vector<ObjCorner>& face, vector<uint8_t>& faceRelative)
+    {
+        ObjData& data = chunk.data;
+        const unsigned int numPositions = (unsigned int)(data.positions.size() / 3);
+        const unsigned int numTexCoords = (unsigned int)(data.texCoords.size() / 2);
+        const unsigned int numNormals = (unsigned int)(data.normals.size() / 3);
+        face.clear();
+        faceRelative.clear();
+        
+        while ((p = skipBlanks(p, end)) < end)
+        {
+            //    v, v/t, v//n or v/t/n
+            ObjCorner corner{-1, -1, -1};
+            uint8_t relative = 0;
+            bool isRelative = false;
+            int index;
+            if (!parseInt(p, end, index) || !resolveIndex(index, numPositions, corner.position, isRelative))
+                return;
+            relative |= isRelative ? RELATIVE_POSITION : 0;
+            if ((p < end) && (*p == '/'))
+            {
+                p++;
+                if ((p < end) && (*p != '/'))
+                {
+                    if (!parseInt(p, end, index) || !resolveIndex(index, numTexCoords, corner.texCoord, isRelative))
+                        return;
+                    relative |= isRelative ? RELATIVE_TEXCOORD : 0;
+                }
+                if ((p < end) && (*p == '/'))
+                {
+                    p++;
+                    if (!parseInt(p, end, index) || !resolveIndex(index, numNormals, corner.normal, isRelative))
+                        return;
+                    relative |= isRelative ? RELATIVE_NORMAL : 0;
+                }
+            }
+            face.push_back(corner);
+            faceRelative.push_back(relative);
+        }
+        
+        //    n-gons become a fan around their first corner
+        for (size_t k = 1; k + 1 < face.size(); k++)
+        {
+            for (size_t c : {(size_t) 0, k, k + 1})
+            {
+                data.corners.push_back(face[c]);
+                chunk.relative.push_back(faceRelative[c]);
+            }
+        }
+    }
+
+    void parseChunk(const char* p, const char* end, ChunkResult& chunk)
+    {
+        ObjData& data = chunk.data;
+        vector<ObjCorner> face;
+        vector<uint8_t> faceRelative;
+        
+        while (p < end)
+        {
+            const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (lineEnd == nullptr)
+                lineEnd = end;
+            
+            const char* q = skipBlanks(p, lineEnd);
+            const char* keyword = q;
+            while ((q < lineEnd) && (*q != ' ') && (*q != '\t') && (*q != '\r'))
+                q++;
+            size_t keywordLength = q - keyword;
+            
+            if ((keywordLength == 1) && (keyword[0] == 'v'))
+            {
+                float xyz[3];
+                if (parseFloat(q, lineEnd, xyz[0]) && parseFloat(q, lineEnd, xyz[1]) && parseFloat(q, lineEnd, xyz[2]))
+                    data.positions.insert(data.positions.end(), xyz, xyz + 3);
+            }
+            else if ((keywordLength == 2) && (keyword[0] == 'v') && (keyword[1] == 'n'))
+            {
+                float xyz[3];
+                if (parseFloat(q, lineEnd, xyz[0]) && parseFloat(q, lineEnd, xyz[1]) && parseFloat(q, lineEnd, xyz[2]))
+                    data.normals.insert(data.normals.end(), xyz, xyz + 3);
+            }
+            else if ((keywordLength == 2) && (keyword[0] == 'v') && (keyword[1] == 't'))
+            {
+                //    v is optional
+                float uv[2] = {0.f, 0.f};
+                if (parseFloat(q, lineEnd, uv[0]))
+                {
+                    parseFloat(q, lineEnd, uv[1]);
+                    data.texCoords.insert(data.texCoords.end(), uv, uv + 2);
+                }
+            }
+            else if ((keywordLength == 1) && (keyword[0] == 'f'))
+                parseFace(q, lineEnd, chunk, face, faceRelative);
+            else if ((keywordLength == 1) && ((keyword[0] == 'o') || (keyword[0] == 'g')))
+            {
+                const char* name = skipBlanks(q, lineEnd);
+                const char* nameEnd = lineEnd;
+                while ((nameEnd > name) && ((nameEnd[-1] == ' ') || (nameEnd[-1] == '\t') || (nameEnd[-1] == '\r')))
+                    nameEnd--;
+                data.groups.push_back(ObjGroup{string(name, nameEnd), data.numTriangles(), 0});
+            }
+            //    anything else (comments, usemtl, s, l...) is skipped
+            
+            p = lineEnd + 1;
+        }
+    }
+
+    /// Appends the chunks in order, turning their relative indices into absolute ones.
+    ObjData merge(vector<ChunkResult>& chunks)
+    {
+        ObjData all = std::move(chunks[0].data);
+        for (size_t i = 1; i < chunks.size(); i++)
+        {
+            ObjData& data = chunks[i].data;
+            const int positionOffset = (int)(all.positions.size() / 3);
+            const int texCoordOffset = (int)(all.texCoords.size() / 2);
+            const int normalOffset = (int)(all.normals.size() / 3);
+            const unsigned int triangleOffset = all.numTriangles();
+            
+            for (size_t c = 0; c < data.corners.size(); c++)
+            {
+                //    absolute indices (from the file's start) are right already
+                ObjCorner& corner = data.corners[c];
+                uint8_t relative = chunks[i].relative[c];
+                if (relative & RELATIVE_POSITION)
+                    corner.position += positionOffset;
+                if (relative & RELATIVE_TEXCOORD)
+                    corner.texCoord += texCoordOffset;
+                if (relative & RELATIVE_NORMAL)
+                    corner.normal += normalOffset;
+            }
+            for (ObjGroup& group : data.groups)
+                group.firstTriangle += triangleOffset;
+            
+            all.positions.insert(all.positions.end(), data.positions.begin(), data.positions.end());
+            all.texCoords.insert(all.texCoords.end(), data.texCoords.begin(), data.texCoords.end());
+            all.normals.insert(all.normals.end(), data.normals.begin(), data.normals.end());
+            all.corners.insert(all.corners.end(), data.corners.begin(), data.corners.end());
+            all.groups.insert(all.groups.end(), data.groups.begin(), data.groups.end());
+            
+            //    free each chunk as soon as it's merged (big files have big chunks)
+            chunks[i] = ChunkResult();
+        }
+        
+        //    faces before the first group, then each group up to the next one
+        //    (a group can span several chunks: its faces are simply those up to the next group)
+        if (all.groups.empty() || (all.groups[0].firstTriangle > 0))
+            all.groups.insert(all.groups.begin(), ObjGroup{"default", 0, 0});
+        for (size_t g = 0; g < all.groups.size(); g++)
+        {
+            unsigned int next = (g + 1 < all.groups.size()) ? all.groups[g + 1].firstTriangle : all.numTriangles();
+            all.groups[g].numTriangles = next - all.groups[g].firstTriangle;
+        }
+        all.groups.erase(remove_if(all.groups.begin(), all.groups.end(),
+                                   [](const ObjGroup& group) { return group.numTriangles == 0; }),
+                         all.groups.end());
+        return all;
+    }
+}
+
+
+ObjData ObjLoader::parse(const char* begin, const char* end, unsigned int numThreads)
+{
+    const size_t size = end - begin;
+    if (numThreads == 0)
+    {
+        numThreads = 1;
+        if (size >= PARALLEL_THRESHOLD)
+            numThreads = (unsigned int) min<size_t>(max(1u, thread::hardware_concurrency()), size / MIN_CHUNK_BYTES);
+    }
+    
+    //    cut at line ends, about evenly
+    vector<const char*> cuts{begin};
+    for (unsigned int i = 1; i < numThreads; i++)
+    {
+        const char* cut = max(begin + i * (size / numThreads), cuts.back());
+        const char* newline = static_cast<const char*>(memchr(cut, '\n', end - cut));
+        cuts.push_back((newline == nullptr) ? end : newline + 1);
+    }
+    cuts.push_back(end);
+    
+    vector<ChunkResult> chunks(numThreads);
+    vector<thread> workers;
+    for (unsigned int i = 1; i < numThreads; i++)
+        workers.emplace_back(parseChunk, cuts[i], cuts[i + 1], ref(chunks[i]));
+    parseChunk(cuts[0], cuts[1], chunks[0]);
+    for (thread& worker : workers)
+        worker.join();
+    
+    return merge(chunks);
+}
+
+
+bool ObjLoader::load(const string& path, ObjData& data)
+{
+    MappedFile file(path);
+    if (!file.isOpen())
+        return false;
+    data = parse(file.begin(), file.end());
+    return true;
+}
+
+
+Mesh ObjLoader::toMesh(const ObjData& data)
+{
+    const int numPositions = (int)(data.positions.size() / 3);
+    const int numNormals = (int)(data.normals.size() / 3);
+    bool hasNormals = !data.corners.empty();
+    for (const ObjCorner& corner : data.corners)
+        hasNormals &= (corner.normal >= 0) && (corner.normal < numNormals);
+    
+    Mesh mesh;
+    mesh.xyz.reserve(3 * data.corners.size());
+    if (hasNormals)
+        mesh.normals.reserve(3 * data.corners.size());
+    for (const ObjGroup& group : data.groups)
+    {
+        unsigned int first = mesh.numVertices();
+        for (unsigned int t = group.firstTriangle; t < group.firstTriangle + group.numTriangles; t++)
+        {
+            const ObjCorner* corners = &data.corners[3*t];
+            //    a face pointing at vertices that don't exist is dropped
+            bool valid = true;
+            for (int k = 0; k < 3; k++)
+                valid &= (corners[k].position >= 0) && (corners[k].position < numPositions);
+            if (!valid)
+                continue;
+            for (int k = 0; k < 3; k++)
+            {
+                const float* xyz = &data.positions[3 * corners[k].position];
+                mesh.xyz.insert(mesh.xyz.end(), xyz, xyz + 3);
+                if (hasNormals)
+                {
+                    const float* normal = &data.normals[3 * corners[k].normal];
+                    mesh.normals.insert(mesh.normals.end(), normal, normal + 3);
+                }
+            }
+        }
+        if (mesh.numVertices() > first)
+            mesh.parts.push_back(MeshPart{GL_TRIANGLES, first, mesh.numVertices() - first});
+    }
+    return mesh;
+}
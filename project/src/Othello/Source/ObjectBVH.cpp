@@ -0,0 +1,119 @@
+//
+//  ObjectBVH.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include "ObjectBVH.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const unsigned int ObjectBVH::LEAF_SIZE = 4;
+
+
+ObjectBVH::ObjectBVH()
+:   nodes_(),
+    objects_(),
+    unbounded_()
+{
+    
+}
+
+
+void ObjectBVH::build(const vector<shared_ptr<GraphicObject3D>>& objects)
+{
+    nodes_.clear();
+    objects_.clear();
+    unbounded_.clear();
+    for (const shared_ptr<GraphicObject3D>& object : objects)
+    {
+        if (object->getWorldBounds().isEmpty())
+            unbounded_.push_back(object);
+        else
+            objects_.push_back(object);
+    }
+    if (!objects_.empty())
+    {
+        nodes_.reserve(2 * objects_.size() / LEAF_SIZE + 1);
+        build_(0, (unsigned int) objects_.size());
+    }
+}
+
+
+unsigned int ObjectBVH::build_(unsigned int first, unsigned int count)
+{
+    unsigned int index = (unsigned int) nodes_.size();
+    nodes_.push_back(Node_{Bounds3D::empty(), first, count, 0});
+    Bounds3D centers = Bounds3D::empty();
+    for (unsigned int i = first; i < first + count; i++)
+    {
+        const Bounds3D& box = objects_[i]->getWorldBounds();
+        nodes_[index].bounds.add(box);
+        float center[3] = {0.5f*(box.min[0] + box.max[0]), 0.5f*(box.min[1] + box.max[1]), 0.5f*(box.min[2] + box.max[2])};
+        centers.add(center);
+    }
+    if (count <= LEAF_SIZE)
+        return index;
+    
+    //    split at the median along the axis where the centers spread the most
+    int axis = 0;
+    for (int k = 1; k < 3; k++)
+        if (centers.max[k] - centers.min[k] > centers.max[axis] - centers.min[axis])
+            axis = k;
+    unsigned int half = count / 2;
+    nth_element(objects_.begin() + first, objects_.begin() + first + half, objects_.begin() + first + count,
+                [axis](const shared_ptr<GraphicObject3D>& a, const shared_ptr<GraphicObject3D>& b)
+                {
+                    return a->getWorldBounds().min[axis] + a->getWorldBounds().max[axis]
+                         < b->getWorldBounds().min[axis] + b->getWorldBounds().max[axis];
+                });
+    build_(first, half);
+    unsigned int secondChild = build_(first + half, count - half);
+    nodes_[index].secondChild = secondChild;
+    return index;
+}
+
+
+void ObjectBVH::cull(const Frustum& frustum, vector<GraphicObject3D*>& visible, CullStats& stats) const
+{
+    for (const shared_ptr<GraphicObject3D>& object : unbounded_)
+        visible.push_back(object.get());
+    stats.drawn += (unsigned int) unbounded_.size();
+    if (nodes_.empty())
+        return;
+    
+    //    depth-first, without recursion (the tree is balanced: 64 levels is more than enough)
+    unsigned int stack[64];
+    unsigned int depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const Node_& node = nodes_[stack[--depth]];
+        Frustum::Test test = frustum.classify(node.bounds);
+        if (test == Frustum::Test::OUTSIDE)
+        {
+            stats.culled += node.count;
+            continue;
+        }
+        bool isLeaf = (node.secondChild == 0);
+        if ((test == Frustum::Test::INSIDE) || isLeaf)
+        {
+            for (unsigned int i = node.first; i < node.first + node.count; i++)
+            {
+                //    a leaf that straddles the frustum still tests its objects one by one
+                if ((test == Frustum::Test::INSIDE) || frustum.mayContain(*objects_[i]))
+                {
+                    visible.push_back(objects_[i].get());
+                    stats.drawn++;
+                }
+                else
+                    stats.culled++;
+            }
+            continue;
+        }
+        unsigned int self = (unsigned int)(&node - nodes_.data());
+        stack[depth++] = node.secondChild;
+        stack[depth++] = self + 1;
+    }
+}
@@ -0,0 +1,174 @@
+//
+//  OffscreenContext.cpp
+//  Othello
+//
+
+#include <iostream>
+#include "OffscreenContext.h"
+
+#if (defined(__FreeBSD__) || defined(linux) || defined(__NetBSD__) || defined(__OpenBSD))
+    #define OFFSCREEN_USES_EGL 1
+    #include <dlfcn.h>
+    #include <EGL/egl.h>
+    #include <EGL/eglext.h>
+#endif
+
+using namespace std;
+using namespace graphics3d;
+
+
+#if OFFSCREEN_USES_EGL
+namespace {
+    //    the few EGL entry points needed, looked up in the library
+    struct EGLFunctions
+    {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay;
+        EGLDisplay (*getDisplay)(EGLNativeDisplayType);
+        EGLBoolean (*initialize)(EGLDisplay, EGLint*, EGLint*);
+        EGLBoolean (*chooseConfig)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+        EGLSurface (*createPbufferSurface)(EGLDisplay, EGLConfig, const EGLint*);
+        EGLBoolean (*bindAPI)(EGLenum);
+        EGLContext (*createContext)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+        EGLBoolean (*makeCurrent)(EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+        EGLBoolean (*destroyContext)(EGLDisplay, EGLContext);
+        EGLBoolean (*destroySurface)(EGLDisplay, EGLSurface);
+        EGLBoolean (*terminate)(EGLDisplay);
+        void* (*getProcAddress)(const char*);
+    };
+
+    template <typename Fn>
+    bool load(void* library, Fn& fn, const char* name)
+    {
+        fn = reinterpret_cast<Fn>(dlsym(library, name));
+        return fn != nullptr;
+    }
+
+    bool loadAll(void* library, EGLFunctions& egl)
+    {
+        bool ok = load(library, egl.getDisplay, "eglGetDisplay");
+        ok &= load(library, egl.initialize, "eglInitialize");
+        ok &= load(library, egl.chooseConfig, "eglChooseConfig");
+        ok &= load(library, egl.createPbufferSurface, "eglCreatePbufferSurface");
+        ok &= load(library, egl.bindAPI, "eglBindAPI");
+        ok &= load(library, egl.createContext, "eglCreateContext");
+        ok &= load(library, egl.makeCurrent, "eglMakeCurrent");
+        ok &= load(library, egl.destroyContext, "eglDestroyContext");
+        ok &= load(library, egl.destroySurface, "eglDestroySurface");
+        ok &= load(library, egl.terminate, "eglTerminate");
+        ok &= load(library, egl.getProcAddress, "eglGetProcAddress");
+        //    optional: without it, fall back on the default display
+        egl.getPlatformDisplay = ok ? reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(egl.getProcAddress("eglGetPlatformDisplayEXT"))
+                                    : nullptr;
+        return ok;
+    }
+    
+    EGLFunctions egl;
+}
+#endif
+
+
+OffscreenContext::OffscreenContext(unsigned int width, unsigned int height)
+:   library_(nullptr),
+    display_(nullptr),
+    surface_(nullptr),
+    context_(nullptr),
+    width_(width),
+    height_(height)
+{
+    if (!create_())
+        context_ = nullptr;
+}
+
+
+bool OffscreenContext::create_()
+{
+#if OFFSCREEN_USES_EGL
+    library_ = dlopen("libEGL.so.1", RTLD_NOW | RTLD_GLOBAL);
+    if ((library_ == nullptr) || !loadAll(library_, egl))
+    {
+        cout << "OffscreenContext ERROR: Unable to load libEGL" << endl;
+        return false;
+    }
+    
+    //    surfaceless: needs neither a display server nor a GPU
+    EGLDisplay display = EGL_NO_DISPLAY;
+    if (egl.getPlatformDisplay != nullptr)
+        display = egl.getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    EGLint major, minor;
+    if ((display == EGL_NO_DISPLAY) || !egl.initialize(display, &major, &minor))
+    {
+        display = egl.getDisplay(EGL_DEFAULT_DISPLAY);
+        if ((display == EGL_NO_DISPLAY) || !egl.initialize(display, &major, &minor))
+        {
+            cout << "OffscreenContext ERROR: No EGL display" << endl;
+            return false;
+        }
+    }
+    display_ = display;
+    
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!egl.chooseConfig(display, configAttributes, &config, 1, &numConfigs) || (numConfigs == 0))
+    {
+        cout << "OffscreenContext ERROR: No RGBA + depth EGL configuration" << endl;
+        return false;
+    }
+    
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, (EGLint) width_, EGL_HEIGHT, (EGLint) height_, EGL_NONE};
+    EGLSurface surface = egl.createPbufferSurface(display, config, surfaceAttributes);
+    if (surface == EGL_NO_SURFACE)
+    {
+        cout << "OffscreenContext ERROR: Unable to create a " << width_ << "x" << height_ << " surface" << endl;
+        return false;
+    }
+    surface_ = surface;
+    
+    //    desktop OpenGL (compatibility profile), like glut gives
+    egl.bindAPI(EGL_OPENGL_API);
+    EGLContext context = egl.createContext(display, config, EGL_NO_CONTEXT, nullptr);
+    if ((context == EGL_NO_CONTEXT) || !egl.makeCurrent(display, surface, surface, context))
+    {
+        cout << "OffscreenContext ERROR: Unable to create an OpenGL context" << endl;
+        return false;
+    }
+    context_ = context;
+    glViewport(0, 0, width_, height_);
+    return true;
+#else
+    cout << "OffscreenContext ERROR: Offscreen rendering needs EGL, not available on this platform" << endl;
+    return false;
+#endif
+}
+
+
+OffscreenContext::~OffscreenContext()
+{
+#if OFFSCREEN_USES_EGL
+    if (display_ != nullptr)
+    {
+        egl.makeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (context_ != nullptr)
+            egl.destroyContext(display_, context_);
+        if (surface_ != nullptr)
+            egl.destroySurface(display_, surface_);
+        egl.terminate(display_);
+    }
+    //    libEGL stays loaded: the GL library may still refer to it
+#endif
+}
+
+
+void OffscreenContext::readPixels(vector<unsigned char>& rgba) const
+{
+    rgba.resize(4 * width_ * height_);
+    glFinish();
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width_, height_, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+}
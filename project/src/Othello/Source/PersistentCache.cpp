@@ -0,0 +1,141 @@
+//
+//  PersistentCache.cpp
+//  Othello
+//
+
+#include "PersistentCache.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace graphics3d;
+using namespace othello;
+
+
+const char PersistentCache::MAGIC_[8] = {'O', 'T', 'H', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t PersistentCache::VERSION_ = 1;
+const unsigned int PersistentCache::MIN_SAVE_DEPTH = 3;
+
+
+PersistentCache::PersistentCache()
+    :
+    file_(nullptr),
+    entries_(nullptr),
+    numEntries_(0)
+{
+
+}
+
+PersistentCache::~PersistentCache() {
+    close_();
+}
+
+
+void PersistentCache::close_() {
+    file_.reset();
+    entries_ = nullptr;
+    numEntries_ = 0;
+}
+
+
+bool PersistentCache::open(const char* filepath, uint64_t fingerprint) {
+    close_();
+    // probes jump all over the file, so don't bother reading ahead
+    unique_ptr<MappedFile> file = make_unique<MappedFile>(filepath, true);
+    if (!file->isOpen())
+        return false; // no snapshot yet, we start cold
+    if (file->size() < sizeof(CacheFileHeader)) {
+        cout << "PersistentCache ERROR: " << filepath << " is too short to be a cache snapshot\n";
+        return false;
+    }
+
+    const CacheFileHeader* header = reinterpret_cast<const CacheFileHeader*>(file->begin());
+    const char* problem = nullptr;
+    if (memcmp(header->magic, MAGIC_, sizeof(MAGIC_)) != 0)
+        problem = "is not a cache snapshot";
+    else if ((header->version != VERSION_) || (header->entrySize != sizeof(TTEntry)))
+        problem = "was written by another version of the engine";
+    else if (header->fingerprint != fingerprint)
+        problem = "was written with other evaluation weights";
+    // (divided rather than multiplied, so a corrupt count can't overflow past the check)
+    else if (header->numEntries > (file->size() - sizeof(CacheFileHeader)) / sizeof(TTEntry))
+        problem = "is truncated";
+    if (problem != nullptr) {
+        cout << "PersistentCache WARNING: " << filepath << " " << problem << ", ignoring it\n";
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const TTEntry*>(file->begin() + sizeof(CacheFileHeader));
+    numEntries_ = header->numEntries;
+    file_ = move(file);
+    return true;
+}
+
+
+bool PersistentCache::probe(uint64_t key, TTEntry& entry) const {
+    const TTEntry* end = entries_ + numEntries_;
+    const TTEntry* found = lower_bound(entries_, end, key, [](const TTEntry& e, uint64_t k) {
+        return e.key < k;
+    });
+    if ((found == end) || (found->key != key))
+        return false;
+    entry = *found;
+    return true;
+}
+
+
+size_t PersistentCache::save(const char* filepath, const TranspositionTable& table, uint64_t fingerprint, size_t maxEntries) const {
+    vector<TTEntry> merged(entries_, entries_ + numEntries_);
+    for (const TTEntry& e : table.getEntries()) {
+        if ((e.key != 0) && (e.bound != Bound::NONE) && (e.depth >= MIN_SAVE_DEPTH))
+            merged.push_back(e);
+    }
+
+    // one entry per position, keeping the deepest result
+    sort(merged.begin(), merged.end(), [](const TTEntry& a, const TTEntry& b) {
+        return (a.key < b.key) || ((a.key == b.key) && (a.depth > b.depth));
+    });
+    merged.erase(unique(merged.begin(), merged.end(), [](const TTEntry& a, const TTEntry& b) {
+        return a.key == b.key;
+    }), merged.end());
+
+    // over budget: evict the shallowest results, they are the cheapest to search again
+    if (merged.size() > maxEntries) {
+        nth_element(merged.begin(), merged.begin() + maxEntries, merged.end(), [](const TTEntry& a, const TTEntry& b) {
+            return a.depth > b.depth;
+        });
+        merged.resize(maxEntries);
+        sort(merged.begin(), merged.end(), [](const TTEntry& a, const TTEntry& b) {
+            return a.key < b.key;
+        });
+    }
+
+    CacheFileHeader header;
+    memcpy(header.magic, MAGIC_, sizeof(MAGIC_));
+    header.version = VERSION_;
+    header.entrySize = sizeof(TTEntry);
+    header.numEntries = merged.size();
+    header.fingerprint = fingerprint;
+
+    // write next to the target and rename over it: the old file stays intact (and mapped) until the new one is complete
+    string tempPath = string(filepath) + ".tmp";
+    ofstream file_data(tempPath, ios::binary | ios::trunc);
+    if (!file_data.is_open()) {
+        cout << "PersistentCache ERROR: Unable to create file " << tempPath << "\n";
+        return 0;
+    }
+    file_data.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file_data.write(reinterpret_cast<const char*>(merged.data()), (streamsize)(merged.size() * sizeof(TTEntry)));
+    file_data.close();
+    if (!file_data || (rename(tempPath.c_str(), filepath) != 0)) {
+        cout << "PersistentCache ERROR: Unable to write " << filepath << "\n";
+        remove(tempPath.c_str());
+        return 0;
+    }
+    return merged.size();
+}
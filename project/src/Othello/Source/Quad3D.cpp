@@ -14,13 +14,13 @@ Quad3D::Quad3D(float width, float height, const Pose& pose, const Motion& motion
     :    GraphicObject3D(pose, motion),
         width_(width),
         height_(height)
-{}
+{
+    setLocalBounds(Bounds3D{{-0.5f*width, -0.5f*height, 0.f}, {0.5f*width, 0.5f*height, 0.f}});
+}
 
 
-void Quad3D::draw() const
+void Quad3D::drawShape() const
 {
-    glPushMatrix();
-    applyPose();
     drawReferenceFrame();
     
     setCurrentMaterial(getMaterial());
@@ -30,8 +30,6 @@ void Quad3D::draw() const
         glVertex3f(+0.5f*width_, +0.5f*height_, 0.f);
         glVertex3f(-0.5f*width_, +0.5f*height_, 0.f);
     glEnd();
-    
-    glPopMatrix();
 }
             
 
@@ -5,63 +5,54 @@
 //  Created by Jean-Yves Hervé on 2023-11-02.
 //
 
+#include <algorithm>
 #include <random>
 #include "QuadMesh3D.h"
+#include "NormalGenerator.h"
 
 using namespace graphics3d;
 using namespace std;
 
+const unsigned int QuadMesh3D::MAX_LOD_LEVELS = 4;
+
 QuadMesh3D::QuadMesh3D(float width, float height, unsigned int numRows, unsigned int numCols,
                        const Pose& pose, const Motion& motion)
     :    GraphicObject3D(pose, motion),
         width_(width),
         height_(height),
-        numRows_(numRows),
-        numCols_(numCols),
-        XYZ_(new GLfloat**[numRows]),
-        normal_(nullptr)
+        grid_(numRows, numCols),
+        buffer_(),
+        bufferValid_(false),
+        lodSteps_(),
+        lodFirstIndex_(),
+        lod_()
 {
-    for (unsigned int i=0; i<numRows; i++)
-    {
-        XYZ_[i] = new GLfloat*[numCols];
-        for (unsigned int j=0; j<numCols; j++)
-        {
-            XYZ_[i][j] = new GLfloat[3];
-        }
-    }
-    
     //    My indices (0, 0) start from bottom left of the mesh
     const GLfloat stepX = width / (numCols-1);
     const GLfloat stepY = height / (numRows-1);
     for (unsigned int i=0; i<numRows; i++)
     {
         const GLfloat y = -0.5f*height + i*stepY;
-        for (unsigned int j=0; j<numCols; j++)
+        GLfloat* vertex = grid_.positionRow(i);
+        for (unsigned int j=0; j<numCols; j++, vertex += VertexGrid::COMPONENTS)
         {
             //    X
-            XYZ_[i][j][0] = -0.5f*width + j*stepX;
+            vertex[0] = -0.5f*width + j*stepX;
             // Y same for all row
-            XYZ_[i][j][1] = y;
+            vertex[1] = y;
             //    Z is zero all over the mesh
-            XYZ_[i][j][2] = 0.f;
+            vertex[2] = 0.f;
         }
     }
+    NormalGenerator::computeGridNormals(grid_);
+    setLocalBounds(Bounds3D::fromPoints(grid_.positions(), grid_.numVertices()));
+    buildLevels_();
 }
 
 QuadMesh3D::QuadMesh3D(float width, float height, unsigned int numRows, unsigned int numCols,
                        float perturbationAmplitude, const Pose& pose, const Motion& motion)
     : QuadMesh3D(width, height, numRows, numCols, pose, motion)
 {
-    normal_ = new GLfloat**[numRows];
-    for (unsigned int i=0; i<numRows; i++)
-    {
-        normal_[i] = new GLfloat*[numCols];
-        for (unsigned int j=0; j<numCols; j++)
-        {
-            normal_[i][j] = new GLfloat[3];
-        }
-    }
-
     // let's perturn the Z component
     random_device myRandDev;
     default_random_engine myEngine(myRandDev());
@@ -69,63 +60,128 @@ QuadMesh3D::QuadMesh3D(float width, float height, unsigned int numRows, unsigned
         
     for (unsigned int i=0; i<numRows; i++)
     {
-        for (unsigned int j=0; j<numCols; j++)
+        GLfloat* vertex = grid_.positionRow(i);
+        for (unsigned int j=0; j<numCols; j++, vertex += VertexGrid::COMPONENTS)
         {
-            XYZ_[i][j][2] += perturbationDist(myEngine);
+            vertex[2] += perturbationDist(myEngine);
         }
     }
     
     // compute the vertex normals
+    NormalGenerator::computeGridNormals(grid_);
+    setLocalBounds(Bounds3D::fromPoints(grid_.positions(), grid_.numVertices()));
 }
 
 
-QuadMesh3D::~QuadMesh3D()
+void QuadMesh3D::drawShape() const
 {
-    for (unsigned int i=0; i<numRows_; i++)
+    drawReferenceFrame();
+    
+    setCurrentMaterial(getMaterial());
+    unsigned int level = lod_.select(getWorldSphere());
+    if (MeshBuffer::available())
     {
-        for (unsigned int j=0; j<numCols_; j++)
+        //    the triangles never change, only where the vertices are
+        if (!buffer_.isUploaded())
         {
-            delete []XYZ_[i][j];
+            vector<GLuint> indices;
+            for (unsigned int step : lodSteps_)
+                appendGridIndices_(step, indices);
+            buffer_.upload(grid_.positions(), grid_.normals(), grid_.numVertices(), indices, GL_DYNAMIC_DRAW);
+        }
+        else if (!bufferValid_)
+            buffer_.updateVertices(grid_.positions(), grid_.normals());
+        bufferValid_ = true;
+        buffer_.draw(lodFirstIndex_[level], (GLsizei)(3 * lod_.numTriangles(level)));
+    }
+    else
+    {
+        vector<unsigned int> rows = sampledLines_(grid_.numRows(), lodSteps_[level]);
+        vector<unsigned int> cols = sampledLines_(grid_.numCols(), lodSteps_[level]);
+        for (unsigned int i=0; i+1<rows.size(); i++)
+        {
+            const GLfloat* bottom = grid_.positionRow(rows[i]);
+            const GLfloat* top = grid_.positionRow(rows[i+1]);
+            const GLfloat* bottomNormal = grid_.normalRow(rows[i]);
+            const GLfloat* topNormal = grid_.normalRow(rows[i+1]);
+            glBegin(GL_TRIANGLE_STRIP);
+            for (unsigned int j : cols)
+            {
+                glNormal3fv(bottomNormal + VertexGrid::COMPONENTS*j);
+                glVertex3fv(bottom + VertexGrid::COMPONENTS*j);
+                glNormal3fv(topNormal + VertexGrid::COMPONENTS*j);
+                glVertex3fv(top + VertexGrid::COMPONENTS*j);
+            }
+            glEnd();
         }
-        delete []XYZ_[i];
     }
-    delete []XYZ_;
+}
+    
+void QuadMesh3D::displaceVertex(unsigned int row, unsigned int col, float dZ)
+{
+    if ((row < grid_.numRows()) && (col < grid_.numCols()))
+    {
+        grid_.position(row, col)[2] += dZ;
+        NormalGenerator::updateGridNormals(grid_, row, col);
+        bufferValid_ = false;
+        //    grow only: shrinking would mean going through every vertex
+        Bounds3D bounds = getLocalBounds();
+        bounds.add(grid_.position(row, col));
+        setLocalBounds(bounds);
+    }
 }
 
-void QuadMesh3D::draw() const
+vector<unsigned int> QuadMesh3D::sampledLines_(unsigned int count, unsigned int step)
 {
-    glPushMatrix();
-    applyPose();
+    vector<unsigned int> lines;
+    for (unsigned int k=0; k<count; k+=step)
+        lines.push_back(k);
+    //    the edges of the mesh stay where they are
+    if (lines.back() != count-1)
+        lines.push_back(count-1);
+    return lines;
+}
 
-    drawReferenceFrame();
-    
-    setCurrentMaterial(getMaterial());
-    for (unsigned int i=0; i<numRows_-1; i++)
+void QuadMesh3D::appendGridIndices_(unsigned int step, vector<GLuint>& indices) const
+{
+    vector<unsigned int> rows = sampledLines_(grid_.numRows(), step);
+    vector<unsigned int> cols = sampledLines_(grid_.numCols(), step);
+    for (unsigned int i=0; i+1<rows.size(); i++)
     {
-        glBegin(GL_TRIANGLE_STRIP);
-        for (unsigned int j=0; j<numCols_; j++)
+        for (unsigned int j=0; j+1<cols.size(); j++)
         {
-            glVertex3fv(XYZ_[i][j]);
-            glVertex3fv(XYZ_[i+1][j]);
+            //    the two triangles of the strip between columns j and j+1
+            GLuint bottomLeft = grid_.index(rows[i], cols[j]), topLeft = grid_.index(rows[i+1], cols[j]);
+            GLuint bottomRight = grid_.index(rows[i], cols[j+1]), topRight = grid_.index(rows[i+1], cols[j+1]);
+            indices.insert(indices.end(), {bottomLeft, topLeft, bottomRight});
+            indices.insert(indices.end(), {topLeft, topRight, bottomRight});
         }
-        glEnd();
     }
-    glPopMatrix();
 }
-    
-void QuadMesh3D::displaceVertex(unsigned int row, unsigned int col, float dZ)
+
+void QuadMesh3D::buildLevels_()
 {
-    if ((row < numRows_) && (col < numCols_))
-        XYZ_[row][col][2] += dZ;
-        
+    //    halve the resolution until a level would be a single quad
+    unsigned int longest = max(grid_.numRows(), grid_.numCols()) - 1;
+    size_t numIndices = 0;
+    for (unsigned int step = 1; (lodSteps_.size() < MAX_LOD_LEVELS) && (step == 1 || step < longest); step *= 2)
+    {
+        unsigned int numRowQuads = (unsigned int) sampledLines_(grid_.numRows(), step).size() - 1;
+        unsigned int numColQuads = (unsigned int) sampledLines_(grid_.numCols(), step).size() - 1;
+        unsigned int numTriangles = 2 * numRowQuads * numColQuads;
+        lodSteps_.push_back(step);
+        lodFirstIndex_.push_back(numIndices);
+        lod_.addLevel((float) max(numRowQuads, numColQuads), numTriangles);
+        numIndices += 3 * numTriangles;
+    }
 }
 
-void QuadMesh3D::faceNormal(GLfloat* v1, GLfloat* v2, GLfloat* v3, GLfloat* v4,
+void QuadMesh3D::faceNormal(const GLfloat* v1, const GLfloat* v2, const GLfloat* v3, const GLfloat* v4,
                 float normal[]) const
 {
     // compute the coordomates of vectors between vertices
-    float dV12[] = {v1[0] - v2[0], v1[1] - v2[2], v1[2] - v2[2]};
-    float dV34[] = {v3[0] - v4[0], v3[1] - v4[2], v3[2] - v4[2]};
+    float dV12[] = {v1[0] - v2[0], v1[1] - v2[1], v1[2] - v2[2]};
+    float dV34[] = {v3[0] - v4[0], v3[1] - v4[1], v3[2] - v4[2]};
     
     // compute crossproduct
     normal[0] = dV12[1]*dV34[2] - dV34[1]*dV12[2];
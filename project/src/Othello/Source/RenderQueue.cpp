@@ -0,0 +1,82 @@
+//
+//  RenderQueue.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <cstring>
+#include "RenderQueue.h"
+
+using namespace std;
+using namespace graphics3d;
+
+
+RenderQueue::RenderQueue()
+:   items_(),
+    depthRow_{0.f, 0.f, -1.f, 0.f}
+{
+    
+}
+
+
+void RenderQueue::begin()
+{
+    items_.clear();
+    GLfloat view[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, view);
+    //    depth grows away from the camera, which looks down -z
+    for (int k = 0; k < 4; k++)
+        depthRow_[k] = -view[4*k + 2];
+}
+
+
+void RenderQueue::add(const GraphicObject3D& object)
+{
+    const float* center = object.getWorldSphere().center;
+    float depth = depthRow_[0]*center[0] + depthRow_[1]*center[1] + depthRow_[2]*center[2] + depthRow_[3];
+    //    objects without a material set draw with whatever is current: count them as opaque
+    bool transparent = (object.getMaterialId() != 0) && isTransparent(object.getMaterial());
+    items_.push_back(Item_{makeKey_(transparent, object.getMaterialId(), depth), &object});
+}
+
+
+uint64_t RenderQueue::makeKey_(bool isTransparent, unsigned int materialId, float depth)
+{
+    //    the bits of a non-negative float sort like the float (what's behind the camera gets 0)
+    uint32_t depthBits = 0;
+    if (depth > 0.f)
+        memcpy(&depthBits, &depth, sizeof(depthBits));
+    uint64_t id = min(materialId, 0xFFFFU);
+    
+    //    opaque:      0 | material (16 bits) | depth, nearest first
+    //    transparent: 1 | depth, furthest first | material (16 bits) (their order matters more than state changes)
+    if (!isTransparent)
+        return (id << 32) | depthBits;
+    return (1ULL << 63) | ((uint64_t)(~depthBits) << 16) | id;
+}
+
+
+void RenderQueue::submit()
+{
+    sort(items_.begin(), items_.end(), [](const Item_& a, const Item_& b) { return a.key < b.key; });
+    
+    bool blending = false;
+    for (const Item_& item : items_)
+    {
+        if (!blending && (item.key >> 63))
+        {
+            //    transparent objects blend over what's already drawn, without hiding each other
+            glEnable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+            blending = true;
+        }
+        item.object->draw();
+    }
+    if (blending)
+    {
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+    }
+    items_.clear();
+}
@@ -0,0 +1,126 @@
+//
+//  SceneNode.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include "SceneNode.h"
+
+using namespace std;
+using namespace graphics3d;
+
+unsigned long SceneNode::numMatrixUpdates_ = 0;
+
+
+SceneNode::SceneNode(const Pose& pose, shared_ptr<GraphicObject3D> object)
+:   pose_(pose),
+    object_(object),
+    parent_(nullptr),
+    children_(),
+    localDirty_(true),
+    worldDirty_(true),
+    hasDirtyDescendant_(false)
+{
+    
+}
+
+
+SceneNode& SceneNode::addChild(const Pose& pose, shared_ptr<GraphicObject3D> object)
+{
+    children_.push_back(make_unique<SceneNode>(pose, object));
+    SceneNode& child = *children_.back();
+    child.parent_ = this;
+    //    the new node starts dirty: let the update find it
+    for (SceneNode* node = this; (node != nullptr) && !node->hasDirtyDescendant_; node = node->parent_)
+        node->hasDirtyDescendant_ = true;
+    return child;
+}
+
+
+void SceneNode::setPose(const Pose& pose)
+{
+    pose_ = pose;
+    localDirty_ = true;
+    markWorldDirty_();
+    //    stop going up at the first node that already knows
+    for (SceneNode* node = parent_; (node != nullptr) && !node->hasDirtyDescendant_; node = node->parent_)
+        node->hasDirtyDescendant_ = true;
+}
+
+
+void SceneNode::markWorldDirty_()
+{
+    //    an already dirty node has all its descendants dirty
+    if (worldDirty_)
+        return;
+    worldDirty_ = true;
+    for (unique_ptr<SceneNode>& child : children_)
+        child->markWorldDirty_();
+}
+
+
+void SceneNode::update()
+{
+    updateWorld_();
+}
+
+
+void SceneNode::updateWorld_()
+{
+    if (worldDirty_)
+    {
+        if (localDirty_)
+        {
+            GraphicObject3D::poseToMatrix(pose_, localMatrix_);
+            localDirty_ = false;
+        }
+        if (parent_ == nullptr)
+            copy(localMatrix_, localMatrix_ + 16, worldMatrix_);
+        else
+            multiply(parent_->worldMatrix_, localMatrix_, worldMatrix_);
+        worldDirty_ = false;
+        numMatrixUpdates_++;
+        if (object_ != nullptr)
+            object_->setPose(GraphicObject3D::matrixToPose(worldMatrix_));
+    }
+    else if (!hasDirtyDescendant_)
+        return;
+    
+    hasDirtyDescendant_ = false;
+    for (unique_ptr<SceneNode>& child : children_)
+        child->updateWorld_();
+}
+
+
+void SceneNode::draw()
+{
+    update();
+    //    the frame the hierarchy is drawn in (e.g. camera to world)
+    GLfloat view[16];
+    glGetFloatv(GL_MODELVIEW_MATRIX, view);
+    glPushMatrix();
+    draw_(view);
+    glPopMatrix();
+}
+
+
+void SceneNode::draw_(const GLfloat view[16]) const
+{
+    if (object_ != nullptr)
+    {
+        GLfloat modelview[16];
+        multiply(view, worldMatrix_, modelview);
+        glLoadMatrixf(modelview);
+        object_->drawShape();
+    }
+    for (const unique_ptr<SceneNode>& child : children_)
+        child->draw_(view);
+}
+
+
+void SceneNode::multiply(const GLfloat a[16], const GLfloat b[16], GLfloat c[16])
+{
+    for (int col = 0; col < 4; col++)
+        for (int row = 0; row < 4; row++)
+            c[4*col + row] = a[row]*b[4*col] + a[4 + row]*b[4*col + 1] + a[8 + row]*b[4*col + 2] + a[12 + row]*b[4*col + 3];
+}
@@ -0,0 +1,167 @@
+//
+//  SearchArena.cpp
+//  Othello
+//
+
+#include "SearchArena.hpp"
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+using namespace std;
+using namespace othello;
+
+
+const unsigned int SearchArena::MAX_PLY = BitBoard::NUM_SQUARES;
+
+#if OTHELLO_COUNT_ALLOCATIONS
+const bool SearchArena::COUNTS_ALLOCATIONS = true;
+#else
+const bool SearchArena::COUNTS_ALLOCATIONS = false;
+#endif
+
+
+#if OTHELLO_COUNT_ALLOCATIONS
+
+namespace {
+    // per thread, so other threads' allocations don't show up in a search's count
+    thread_local uint64_t numAllocations = 0;
+
+    void* countedAllocate(size_t size) noexcept {
+        numAllocations++;
+        return malloc(size ? size : 1);
+    }
+
+    void* countedAllocate(size_t size, align_val_t alignment) noexcept {
+        numAllocations++;
+#if defined(_MSC_VER)
+        return _aligned_malloc(size ? size : 1, static_cast<size_t>(alignment));
+#else
+        void* p = nullptr;
+        return (posix_memalign(&p, static_cast<size_t>(alignment), size ? size : 1) == 0) ? p : nullptr;
+#endif
+    }
+
+    void alignedFree(void* p) noexcept {
+#if defined(_MSC_VER)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+}
+
+
+// Counting replacements of the global allocation functions: the plain, array & nothrow forms, and their
+// aligned (align_val_t) versions, are all counted. Placement new doesn't allocate and isn't replaced.
+void* operator new(size_t size) {
+    void* p = countedAllocate(size);
+    if (p == nullptr)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new(size_t size, align_val_t alignment) {
+    void* p = countedAllocate(size, alignment);
+    if (p == nullptr)
+        throw bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size, align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, align_val_t alignment, const nothrow_t&) noexcept {
+    return countedAllocate(size, alignment);
+}
+
+void* operator new[](size_t size, align_val_t alignment, const nothrow_t&) noexcept {
+    return countedAllocate(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, const nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, const nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void* p, size_t, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, size_t, align_val_t) noexcept {
+    alignedFree(p);
+}
+
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept {
+    alignedFree(p);
+}
+
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept {
+    alignedFree(p);
+}
+
+#endif
+
+
+SearchArena::SearchArena()
+    :   plies_(MAX_PLY + 2)
+{
+
+}
+
+
+SearchArena& SearchArena::local() {
+    static thread_local SearchArena arena;
+    return arena;
+}
+
+
+uint64_t SearchArena::heapAllocations() {
+#if OTHELLO_COUNT_ALLOCATIONS
+    return numAllocations;
+#else
+    return 0;
+#endif
+}
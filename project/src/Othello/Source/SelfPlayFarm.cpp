@@ -0,0 +1,282 @@
+//
+//  SelfPlayFarm.cpp
+//  Othello
+//
+
+#include "SelfPlayFarm.hpp"
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace othello;
+
+
+const int SelfPlayFarm::RANDOM_OPENING_PLIES_ = 6;
+const unsigned int SelfPlayFarm::MAX_RESTARTS_PER_WORKER_ = 10;
+
+
+SelfPlayFarm::SelfPlayFarm(unsigned int numWorkers, unsigned int depth)
+    :
+    numWorkers_((numWorkers > 0) ? numWorkers : max(1u, thread::hardware_concurrency())),
+    depth_(depth)
+{
+
+}
+
+
+bool SelfPlayFarm::readFully_(int fd, void* data, size_t size) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t n = read(fd, bytes, size);
+        if ((n < 0) && (errno == EINTR))
+            continue;
+        if (n <= 0)
+            return false;
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+bool SelfPlayFarm::writeFully_(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t n = write(fd, bytes, size);
+        if ((n < 0) && (errno == EINTR))
+            continue;
+        if (n <= 0)
+            return false;
+        bytes += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+
+bool SelfPlayFarm::spawnWorker_(Worker_& worker) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        cout << "SelfPlayFarm ERROR: Unable to create a socket pair\n";
+        return false;
+    }
+    cout.flush(); // or the child would inherit (and maybe repeat) whatever is still buffered
+    pid_t pid = fork();
+    if (pid < 0) {
+        cout << "SelfPlayFarm ERROR: Unable to fork a worker\n";
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // worker: keep only our own end of our own socket
+        close(fds[0]);
+        for (const Worker_& other : workers_) {
+            if (other.fd >= 0)
+                close(other.fd);
+        }
+        workerMain_(fds[1]);
+        _exit(0); // skip the coordinator's atexit handlers & stream buffers
+    }
+    close(fds[1]);
+    worker = Worker_{pid, fds[0], -1};
+    return true;
+}
+
+
+bool SelfPlayFarm::restartWorker_(Worker_& worker) {
+    close(worker.fd);
+    worker.fd = -1;
+    int status = 0;
+    waitpid(worker.pid, &status, 0);
+    cout << "SelfPlayFarm WARNING: worker " << worker.pid;
+    if (WIFSIGNALED(status))
+        cout << " was killed by signal " << WTERMSIG(status);
+    else
+        cout << " exited with status " << WEXITSTATUS(status);
+    cout << " during game " << worker.gameIndex << ", restarting it\n";
+    return spawnWorker_(worker);
+}
+
+
+void SelfPlayFarm::workerMain_(int fd) const {
+    AiMind mind(AiMind::DEFAULT_WEIGHTS, RGBColor{0.f, 0.f, 0.5f});
+    vector<TrainingPosition> positions;
+    Assignment_ assignment;
+    while (readFully_(fd, &assignment, sizeof(assignment))) {
+        ResultHeader_ header;
+        header.gameIndex = assignment.gameIndex;
+        header.finalDiscDiff = playGame_(mind, assignment.gameIndex, positions);
+        header.numPositions = (uint32_t)positions.size();
+        if (!writeFully_(fd, &header, sizeof(header)) ||
+            !writeFully_(fd, positions.data(), positions.size() * sizeof(TrainingPosition)))
+            break;
+    }
+    close(fd);
+}
+
+
+int SelfPlayFarm::playGame_(AiMind& mind, uint32_t gameIndex, vector<TrainingPosition>& positions) const {
+    positions.clear();
+    // the game index seeds the opening, so a game handed out again after a crash is replayed identically
+    default_random_engine engine(gameIndex);
+    BitBoard pos = BitBoard::initialPosition();
+    bool blackToMove = true;
+    SearchLimits limits{depth_, 0, 0.0, nullptr};
+    for (int ply = 0; ; ply++) {
+        uint64_t legal = pos.legalMoves(blackToMove);
+        if (legal == 0) {
+            if (pos.legalMoves(!blackToMove) == 0)
+                break; // game over
+            blackToMove = !blackToMove; // forced pass
+            continue;
+        }
+        int move;
+        if (ply < RANDOM_OPENING_PLIES_) {
+            int pick = uniform_int_distribution<int>(0, BitBoard::popCount(legal) - 1)(engine);
+            while (pick-- > 0)
+                legal &= legal - 1;
+            move = BitBoard::lowestSquare(legal);
+        } else {
+            SearchInfo result = mind.searchIterative(pos, blackToMove, limits, [](const SearchInfo&) {
+                return true;
+            });
+            positions.push_back(TrainingPosition{pos, (uint8_t)blackToMove, result.score});
+            move = result.bestMove;
+        }
+        pos.play(move, blackToMove);
+        blackToMove = !blackToMove;
+    }
+    return BitBoard::popCount(pos.black) - BitBoard::popCount(pos.white);
+}
+
+
+void SelfPlayFarm::writeGame_(ofstream& output, const ResultHeader_& header, const vector<TrainingPosition>& positions) {
+    char squares[BitBoard::NUM_SQUARES + 1];
+    squares[BitBoard::NUM_SQUARES] = '\0';
+    for (size_t p = 0; p < positions.size(); p++) {
+        const TrainingPosition& tp = positions[p];
+        for (int sq = 0; sq < BitBoard::NUM_SQUARES; sq++) {
+            uint64_t bit = 1ULL << sq;
+            squares[sq] = (tp.position.black & bit) ? 'X' : ((tp.position.white & bit) ? 'O' : '-');
+        }
+        // the game result, from the side to move's point of view like the score
+        int result = tp.blackToMove ? header.finalDiscDiff : -header.finalDiscDiff;
+        output << header.gameIndex << '\t' << p << '\t' << squares << '\t' << (tp.blackToMove ? "black" : "white")
+               << '\t' << tp.score << '\t' << result << '\n';
+    }
+    // flushed game by game, so everything finished so far survives whatever happens next
+    output.flush();
+}
+
+
+size_t SelfPlayFarm::run(unsigned int numGames, const char* outputPath) {
+    ofstream output(outputPath);
+    if (!output.is_open()) {
+        cout << "SelfPlayFarm ERROR: Unable to open output file " << outputPath << "\n";
+        return 0;
+    }
+    output << "game\tindex\tboard\tto_move\tscore\tresult\n";
+    output.flush();
+
+    // a worker dying mid-write must not take the coordinator down with it
+    signal(SIGPIPE, SIG_IGN);
+
+    workers_.assign(numWorkers_, Worker_{-1, -1, -1});
+    for (Worker_& worker : workers_) {
+        if (!spawnWorker_(worker))
+            return 0;
+    }
+
+    deque<uint32_t> pending;
+    for (uint32_t g = 0; g < numGames; g++)
+        pending.push_back(g);
+    size_t numCompleted = 0, numPositions = 0;
+    unsigned int numRestarts = 0;
+    bool failed = false;
+    vector<TrainingPosition> positions;
+    auto start = chrono::steady_clock::now();
+
+    // a crashed worker's game goes back to the front of the queue
+    auto recover = [&](Worker_& worker) {
+        if (worker.gameIndex >= 0)
+            pending.push_front((uint32_t)worker.gameIndex);
+        if ((++numRestarts > MAX_RESTARTS_PER_WORKER_ * numWorkers_) || !restartWorker_(worker)) {
+            cout << "SelfPlayFarm ERROR: too many worker failures, stopping\n";
+            failed = true;
+        }
+    };
+
+    while ((numCompleted < numGames) && !failed) {
+        // hand out games to the idle workers
+        for (Worker_& worker : workers_) {
+            if ((worker.gameIndex >= 0) || pending.empty())
+                continue;
+            Assignment_ assignment{pending.front()};
+            pending.pop_front();
+            worker.gameIndex = assignment.gameIndex;
+            if (!writeFully_(worker.fd, &assignment, sizeof(assignment)))
+                recover(worker);
+        }
+
+        // wait for any busy worker to report back (or to die: its socket then reads as closed)
+        vector<pollfd> polled;
+        vector<size_t> polledWorkers;
+        for (size_t w = 0; w < workers_.size(); w++) {
+            if (workers_[w].gameIndex >= 0) {
+                polled.push_back(pollfd{workers_[w].fd, POLLIN, 0});
+                polledWorkers.push_back(w);
+            }
+        }
+        if (polled.empty())
+            continue;
+        if (poll(polled.data(), polled.size(), -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            cout << "SelfPlayFarm ERROR: poll failed\n";
+            break;
+        }
+        for (size_t i = 0; i < polled.size(); i++) {
+            if (polled[i].revents == 0)
+                continue;
+            Worker_& worker = workers_[polledWorkers[i]];
+            ResultHeader_ header;
+            bool ok = readFully_(worker.fd, &header, sizeof(header));
+            if (ok) {
+                positions.resize(header.numPositions);
+                ok = readFully_(worker.fd, positions.data(), positions.size() * sizeof(TrainingPosition));
+            }
+            if (!ok) {
+                recover(worker);
+                continue;
+            }
+            writeGame_(output, header, positions);
+            worker.gameIndex = -1;
+            numCompleted++;
+            numPositions += positions.size();
+        }
+    }
+
+    // closing the sockets tells the workers to exit
+    for (Worker_& worker : workers_) {
+        if (worker.fd >= 0)
+            close(worker.fd);
+        if (worker.pid > 0)
+            waitpid(worker.pid, nullptr, 0);
+    }
+    workers_.clear();
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Self-play: " << numCompleted << " games, " << numPositions << " positions at depth " << depth_
+         << " on " << numWorkers_ << " worker processes in " << secs << " s ("
+         << (secs > 0 ? numCompleted / secs : 0) << " games/sec), " << numRestarts << " restarts\n";
+    return numCompleted;
+}
@@ -0,0 +1,212 @@
+//
+//  SessionManager.cpp
+//  Othello
+//
+
+#include "SessionManager.hpp"
+#include <algorithm>
+
+using namespace std;
+using namespace othello;
+
+
+SessionManager::SessionManager(unsigned int numWorkers, const shared_ptr<const PersistentCache>& sharedCache)
+    :
+    nextSessionId_(1),
+    numBusyWorkers_(0),
+    stopping_(false),
+    sharedCache_(sharedCache)
+{
+    if (numWorkers == 0)
+        numWorkers = max(1u, thread::hardware_concurrency());
+    for (unsigned int w = 0; w < numWorkers; w++)
+        workers_.emplace_back(&SessionManager::workerLoop_, this);
+}
+
+SessionManager::~SessionManager() {
+    {
+        lock_guard<mutex> lock(lock_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (thread& worker : workers_)
+        worker.join();
+}
+
+
+uint32_t SessionManager::createSession(bool aiPlaysBlack, const SessionBudget& budget) {
+    lock_guard<mutex> lock(lock_);
+    uint32_t sessionId = nextSessionId_++;
+    sessions_[sessionId] = Session_{BitBoard::initialPosition(), true, aiPlaysBlack, false, budget};
+    return sessionId;
+}
+
+
+void SessionManager::closeSession(uint32_t sessionId) {
+    lock_guard<mutex> lock(lock_);
+    // a queued request for it is dropped when a worker picks it up
+    sessions_.erase(sessionId);
+}
+
+
+bool SessionManager::playMove(uint32_t sessionId, int sq) {
+    lock_guard<mutex> lock(lock_);
+    auto found = sessions_.find(sessionId);
+    if (found == sessions_.end())
+        return false;
+    Session_& session = found->second;
+    if ((session.blackToMove == session.aiPlaysBlack) || session.aiMovePending)
+        return false;
+    if (!session.position.play(sq, session.blackToMove))
+        return false;
+    session.blackToMove = !session.blackToMove;
+    skipForcedPass_(session);
+    return true;
+}
+
+
+bool SessionManager::requestAiMove(uint32_t sessionId, const MoveCallback& onMove) {
+    {
+        lock_guard<mutex> lock(lock_);
+        auto found = sessions_.find(sessionId);
+        if (found == sessions_.end())
+            return false;
+        Session_& session = found->second;
+        if ((session.blackToMove != session.aiPlaysBlack) || session.aiMovePending || isGameOver(session.position))
+            return false;
+        session.aiMovePending = true;
+        queue_.push_back(Request_{sessionId, chrono::steady_clock::now(), onMove});
+    }
+    {
+        lock_guard<mutex> lock(statsLock_);
+        if (firstRequest_ == chrono::steady_clock::time_point())
+            firstRequest_ = chrono::steady_clock::now();
+    }
+    workAvailable_.notify_one();
+    return true;
+}
+
+
+bool SessionManager::getPosition(uint32_t sessionId, BitBoard& pos, bool& blackToMove) const {
+    lock_guard<mutex> lock(lock_);
+    auto found = sessions_.find(sessionId);
+    if (found == sessions_.end())
+        return false;
+    pos = found->second.position;
+    blackToMove = found->second.blackToMove;
+    return true;
+}
+
+
+bool SessionManager::isGameOver(const BitBoard& pos) {
+    return (pos.legalMoves(true) == 0) && (pos.legalMoves(false) == 0);
+}
+
+
+void SessionManager::skipForcedPass_(Session_& session) {
+    if ((session.position.legalMoves(session.blackToMove) == 0) && (session.position.legalMoves(!session.blackToMove) != 0))
+        session.blackToMove = !session.blackToMove;
+}
+
+
+void SessionManager::waitIdle() {
+    unique_lock<mutex> lock(lock_);
+    idle_.wait(lock, [this]() { return queue_.empty() && (numBusyWorkers_ == 0); });
+}
+
+
+void SessionManager::workerLoop_() {
+    // each worker has its own AI (and so its own first-level table), only the read-only cache is shared
+    AiMind mind(AiMind::DEFAULT_WEIGHTS, RGBColor{0.f, 0.f, 0.5f});
+    mind.setPersistentCache(sharedCache_);
+
+    while (true) {
+        Request_ request;
+        Session_ session;
+        {
+            unique_lock<mutex> lock(lock_);
+            workAvailable_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+            if (stopping_)
+                return;
+            request = move(queue_.front());
+            queue_.pop_front();
+            auto found = sessions_.find(request.sessionId);
+            if (found == sessions_.end()) {
+                // the game was closed while its request was queued
+                if (queue_.empty() && (numBusyWorkers_ == 0))
+                    idle_.notify_all();
+                continue;
+            }
+            session = found->second;
+            numBusyWorkers_++;
+        }
+
+        // searched on a copy, so the other games are never locked out while this one thinks
+        SearchLimits limits{session.budget.maxDepth, session.budget.maxNodes, session.budget.maxSeconds, &stopping_};
+        SearchInfo result = mind.searchIterative(session.position, session.blackToMove, limits, [](const SearchInfo&) {
+            return true;
+        });
+        if (stopping_)
+            return;
+
+        bool played = false;
+        {
+            lock_guard<mutex> lock(lock_);
+            auto found = sessions_.find(request.sessionId);
+            if (found != sessions_.end()) {
+                Session_& live = found->second;
+                live.aiMovePending = false;
+                if (result.bestMove >= 0)
+                    live.position.play(result.bestMove, live.blackToMove);
+                live.blackToMove = !live.blackToMove;
+                skipForcedPass_(live);
+                played = true;
+            }
+        }
+        if (played) {
+            double latency = chrono::duration<double, milli>(chrono::steady_clock::now() - request.queuedAt).count();
+            {
+                lock_guard<mutex> lock(statsLock_);
+                latencies_.push_back((float)latency);
+                lastServed_ = chrono::steady_clock::now();
+            }
+            if (request.onMove)
+                request.onMove(request.sessionId, result.bestMove);
+        }
+
+        // only idle once the callback has returned, since it may have queued the game's next request
+        {
+            lock_guard<mutex> lock(lock_);
+            numBusyWorkers_--;
+            if (queue_.empty() && (numBusyWorkers_ == 0))
+                idle_.notify_all();
+        }
+    }
+}
+
+
+HostingReport SessionManager::report() const {
+    vector<float> latencies;
+    double seconds;
+    {
+        lock_guard<mutex> lock(statsLock_);
+        latencies = latencies_;
+        seconds = chrono::duration<double>(lastServed_ - firstRequest_).count();
+    }
+    HostingReport result{latencies.size(), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (latencies.empty())
+        return result;
+
+    result.seconds = seconds;
+    result.movesPerSecond = (result.seconds > 0) ? latencies.size() / result.seconds : 0.0;
+    sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        size_t index = (size_t)(p * (latencies.size() - 1) + 0.5);
+        return (double)latencies[index];
+    };
+    result.latencyP50 = percentile(0.50);
+    result.latencyP95 = percentile(0.95);
+    result.latencyP99 = percentile(0.99);
+    result.latencyMax = latencies.back();
+    return result;
+}
@@ -0,0 +1,81 @@
+//
+//  TimeManager.cpp
+//  Othello
+//
+
+#include "TimeManager.hpp"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+using namespace othello;
+
+
+const double TimeManager::RESERVE_SECONDS_ = 0.05;
+const int TimeManager::MIN_MOVES_LEFT_ = 4;
+const double TimeManager::INCREMENT_SHARE_ = 0.8;
+const double TimeManager::MAX_CLOCK_SHARE_ = 0.25;
+const double TimeManager::MIN_SCALE_ = 0.25;
+const double TimeManager::MAX_SCALE_ = 3.0;
+const double TimeManager::BEST_MOVE_CHANGE_FACTOR_ = 1.5;
+const double TimeManager::SCORE_DROP_FACTOR_ = 1.3;
+const double TimeManager::DOMINANT_FACTOR_ = 0.6;
+const int TimeManager::SCORE_DROP_ = 10;
+const int TimeManager::DOMINANCE_MARGIN_ = 40;
+const double TimeManager::DEFAULT_GROWTH_ = 4.0;
+
+
+TimeManager::TimeManager(const GameClock& clock, int numEmpties)
+    :
+    scale_(1.0),
+    lastBestMove_(-1),
+    lastScore_(0),
+    lastIterationSeconds_(0.0),
+    lastElapsed_(0.0),
+    stableIterations_(0)
+{
+    // the two players alternate, so about half of the empty squares will be ours to fill
+    int movesLeft = max((numEmpties + 1) / 2, MIN_MOVES_LEFT_);
+    double usable = max(clock.remainingSeconds - RESERVE_SECONDS_, 0.0);
+    softLimit_ = usable / movesLeft + clock.incrementSeconds * INCREMENT_SHARE_;
+    hardLimit_ = min(softLimit_ * MAX_SCALE_, usable * MAX_CLOCK_SHARE_ + clock.incrementSeconds * INCREMENT_SHARE_);
+    // with almost nothing left on the clock, still give depth 1 a chance
+    hardLimit_ = max(hardLimit_, 0.001);
+    softLimit_ = min(softLimit_, hardLimit_);
+}
+
+
+bool TimeManager::continueSearch(const SearchInfo& info) {
+    double iterationSeconds = info.seconds - lastElapsed_;
+
+    if (info.runnerUpScore == INT_MIN)
+        return false; // only one legal move, there's nothing to think about
+
+    if (lastBestMove_ >= 0) {
+        if (info.bestMove != lastBestMove_) {
+            scale_ *= BEST_MOVE_CHANGE_FACTOR_;
+            stableIterations_ = 0;
+        } else {
+            stableIterations_++;
+        }
+        if (info.score <= lastScore_ - SCORE_DROP_)
+            scale_ *= SCORE_DROP_FACTOR_;
+    }
+    if ((stableIterations_ >= 2) && (info.score - info.runnerUpScore >= DOMINANCE_MARGIN_))
+        scale_ *= DOMINANT_FACTOR_;
+    scale_ = min(max(scale_, MIN_SCALE_), MAX_SCALE_);
+
+    // each iteration costs a roughly constant factor more than the one before it
+    double growth = (lastIterationSeconds_ > 0) ? iterationSeconds / lastIterationSeconds_ : DEFAULT_GROWTH_;
+    growth = min(max(growth, 2.0), 10.0);
+
+    lastBestMove_ = info.bestMove;
+    lastScore_ = info.score;
+    lastIterationSeconds_ = iterationSeconds;
+    lastElapsed_ = info.seconds;
+
+    if (info.seconds >= min(softLimit_ * scale_, hardLimit_))
+        return false;
+    // an iteration that can't finish before the hard limit would be thrown away, so don't start it
+    return info.seconds + iterationSeconds * growth < hardLimit_;
+}
@@ -0,0 +1,65 @@
+//
+//  TranspositionTable.cpp
+//  Othello
+//
+
+#include "TranspositionTable.hpp"
+#include <algorithm>
+
+using namespace std;
+using namespace othello;
+
+
+namespace {
+    // mixed into the position hash so the same discs with a different side to move
+    // or evaluation perspective land in different slots
+    const uint64_t BLACK_TO_MOVE_KEY = 0x6A09E667F3BCC909ULL;
+    const uint64_t BLACK_PERSPECTIVE_KEY = 0xBB67AE8584CAA73BULL;
+}
+
+
+TranspositionTable::TranspositionTable(unsigned int sizeLog2)
+    :
+    entries_(size_t(1) << sizeLog2),
+    mask_((uint64_t(1) << sizeLog2) - 1)
+{
+    clear();
+}
+
+
+uint64_t TranspositionTable::key(const BitBoard& pos, bool blackToMove, bool blackPerspective, Symmetry& used) {
+    uint64_t k = pos.canonicalHash(used);
+    if (blackToMove)
+        k ^= BLACK_TO_MOVE_KEY;
+    if (blackPerspective)
+        k ^= BLACK_PERSPECTIVE_KEY;
+    // 0 marks empty slots
+    return (k == 0) ? 1 : k;
+}
+
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const TTEntry& slot = entries_[key & mask_];
+    if (slot.key != key)
+        return false;
+    entry = slot;
+    return true;
+}
+
+
+void TranspositionTable::store(uint64_t key, unsigned int depth, Bound bound, int score, int canonicalMove) {
+    TTEntry& slot = entries_[key & mask_];
+    if ((slot.key == key) && (slot.depth > depth))
+        return;
+    slot.key = key;
+    slot.score = score;
+    slot.depth = (uint8_t)min(depth, 255u);
+    slot.bound = bound;
+    slot.move = (canonicalMove < 0) ? TTEntry::NO_MOVE : (uint8_t)canonicalMove;
+    slot.padding = 0;
+}
+
+
+void TranspositionTable::clear() {
+    fill(entries_.begin(), entries_.end(), TTEntry{0, 0, 0, Bound::NONE, TTEntry::NO_MOVE, 0});
+}
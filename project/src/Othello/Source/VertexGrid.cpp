@@ -0,0 +1,37 @@
+//
+//  VertexGrid.cpp
+//  Othello
+//
+
+#include <algorithm>
+#include <new>
+#include "VertexGrid.h"
+
+using namespace std;
+using namespace graphics3d;
+
+const size_t VertexGrid::ALIGNMENT = 64;
+
+
+VertexGrid::VertexGrid(unsigned int numRows, unsigned int numCols)
+:   numRows_(numRows),
+    numCols_(numCols),
+    xyz_(allocate_(COMPONENTS * numRows * numCols)),
+    normals_(allocate_(COMPONENTS * numRows * numCols))
+{
+    
+}
+
+
+unique_ptr<GLfloat[], VertexGrid::AlignedDelete_> VertexGrid::allocate_(size_t numFloats)
+{
+    GLfloat* block = static_cast<GLfloat*>(::operator new[](numFloats * sizeof(GLfloat), align_val_t(ALIGNMENT)));
+    fill(block, block + numFloats, 0.f);
+    return unique_ptr<GLfloat[], AlignedDelete_>(block);
+}
+
+
+void VertexGrid::AlignedDelete_::operator()(GLfloat* block) const
+{
+    ::operator delete[](block, align_val_t(ALIGNMENT));
+}
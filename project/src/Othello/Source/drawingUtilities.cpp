@@ -5,29 +5,46 @@
 //  Created by Jean-Yves Hervé on 2023-10-30.
 //
 
+#include <cstring>
+#include <vector>
 #include "drawingUtilities.h"
 
 extern bool drawReferenceFrames;
 
+//    What the state cache believes the GL state is
+static Material currentMaterial;
+static bool currentMaterialKnown = false;
+static GLenum currentShadeModel = 0;
+//    -1 unknown, else 0/1
+static int currentLighting = -1;
+static RenderStateStats stateStats = {0, 0, 0, 0, 0};
+
 
 //     Allows to define the reflectance properties of the current object's material
 void setCurrentMaterial(GLfloat ambRed, GLfloat ambGreen, GLfloat ambBlue, GLfloat difRed,
     GLfloat difGreen, GLfloat difBlue, GLfloat specRed, GLfloat specGreen,
     GLfloat specBlue, GLfloat shine)
 {
-    GLfloat ambient[4] = {ambRed, ambGreen, ambBlue, 1.f};
-    GLfloat diffuse[4] = {difRed, difGreen, difBlue, 1.f};
-    GLfloat specular[4] = {specRed, specGreen, specBlue, 1.f};
-    GLfloat emission[4] = {0.f, 0.f, 0.f, 1.f};
-    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
-    glMaterialfv(GL_FRONT, GL_EMISSION, emission);
-    glMaterialf(GL_FRONT, GL_SHININESS, shine * 128.f);
+    Material mat = {{ambRed, ambGreen, ambBlue, 1.f,
+                     difRed, difGreen, difBlue, 1.f,
+                     specRed, specGreen, specBlue, 1.f,
+                     0.f, 0.f, 0.f, 1.f,
+                     shine}};
+    setCurrentMaterial(mat);
 }
 
 void setCurrentMaterial(const Material& mat)
 {
+    if (currentMaterialKnown && (memcmp(currentMaterial.aMaterial, mat.aMaterial, sizeof(mat.aMaterial)) == 0))
+    {
+        stateStats.materialsSkipped++;
+        stateStats.callsSkipped += 5;
+        return;
+    }
+    currentMaterial = mat;
+    currentMaterialKnown = true;
+    stateStats.materialChanges++;
+    
     glMaterialfv(GL_FRONT, GL_AMBIENT, mat.aMaterial);
     glMaterialfv(GL_FRONT, GL_DIFFUSE, mat.aMaterial+4);
     glMaterialfv(GL_FRONT, GL_SPECULAR, mat.aMaterial+8);
@@ -35,6 +52,66 @@ void setCurrentMaterial(const Material& mat)
     glMaterialf(GL_FRONT, GL_SHININESS, mat.aMaterial[16] * 128.f);
 }
 
+void setShadeModel(GLenum model)
+{
+    if (model == currentShadeModel)
+    {
+        stateStats.callsSkipped++;
+        return;
+    }
+    currentShadeModel = model;
+    stateStats.shadeModelChanges++;
+    glShadeModel(model);
+}
+
+void setLighting(bool enabled)
+{
+    if (currentLighting == (enabled ? 1 : 0))
+    {
+        stateStats.callsSkipped++;
+        return;
+    }
+    currentLighting = enabled ? 1 : 0;
+    stateStats.lightingChanges++;
+    if (enabled)
+        glEnable(GL_LIGHTING);
+    else
+        glDisable(GL_LIGHTING);
+}
+
+void invalidateRenderState(void)
+{
+    currentMaterialKnown = false;
+    currentShadeModel = 0;
+    currentLighting = -1;
+}
+
+const RenderStateStats& renderStateStats(void)
+{
+    return stateStats;
+}
+
+void resetRenderStateStats(void)
+{
+    stateStats = {0, 0, 0, 0, 0};
+}
+
+unsigned int materialId(const Material& mat)
+{
+    //    scenes have a handful of materials: a list is all it takes
+    static std::vector<Material> knownMaterials;
+    for (size_t i = 0; i < knownMaterials.size(); i++)
+        if (memcmp(knownMaterials[i].aMaterial, mat.aMaterial, sizeof(mat.aMaterial)) == 0)
+            return (unsigned int)(i + 1);
+    knownMaterials.push_back(mat);
+    return (unsigned int) knownMaterials.size();
+}
+
+bool isTransparent(const Material& mat)
+{
+    return mat.aMaterial[7] < 1.f;
+}
+
 //void saveAndSetMaterial(Material& currentMat, const Material& newMat)
 //{
 //    glGetMaterialfv(GL_FRONT,  GL_AMBIENT,  currentMat.sMaterial.ambient);
@@ -53,17 +130,17 @@ void updateRenderingMode(RenderingMode renderingMode)
         //    If we were in wireframe mode, we switch to flat shading
         case RenderingMode::WireframeRender:
             glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            glShadeModel(GL_FLAT);
+            setShadeModel(GL_FLAT);
              break;
         //    Else we switch to wireframe
         case RenderingMode::FlatShadingRender:
             glPolygonMode(GL_FRONT, GL_FILL);
-            glShadeModel(GL_FLAT);
+            setShadeModel(GL_FLAT);
             break;
 
         case RenderingMode::SmoothShadingRender:
             glPolygonMode(GL_FRONT, GL_FILL);
-            glShadeModel(GL_SMOOTH);
+            setShadeModel(GL_SMOOTH);
             break;
     }
 }
@@ -71,20 +148,22 @@ void updateRenderingMode(RenderingMode renderingMode)
 //    Draws the three axes of the local reference frame
 void drawReferenceFrame(void)
 {
-    if (drawReferenceFrames)
-        glBegin(GL_LINES);
-            //    X --> red.
-            setCurrentMaterial(1.0, 0., 0., 1., 0., 0., 0., 0., 0., 0.);
-            glVertex3f(-0.1, 0., 0.);
-            glVertex3f(0.5, 0., 0.);
-            //    Y --> green
-            setCurrentMaterial(0., 0., 1.0, 0., 0., 1., 0., 0., 0., 0.);
-            glVertex3f(0., -0.1, 0.);
-            glVertex3f(0., 0.5, 0.);
-            //    Z --> blue
-            setCurrentMaterial(0., 1.0, 0., 0., 1., 0., 0., 0., 0., 0.);
-            glVertex3f(0., 0., -0.1);
-            glVertex3f(0., 0., 0.5);
-        glEnd();
+    if (!drawReferenceFrames)
+        return;
+    
+    glBegin(GL_LINES);
+        //    X --> red.
+        setCurrentMaterial(1.0, 0., 0., 1., 0., 0., 0., 0., 0., 0.);
+        glVertex3f(-0.1, 0., 0.);
+        glVertex3f(0.5, 0., 0.);
+        //    Y --> green
+        setCurrentMaterial(0., 0., 1.0, 0., 0., 1., 0., 0., 0., 0.);
+        glVertex3f(0., -0.1, 0.);
+        glVertex3f(0., 0.5, 0.);
+        //    Z --> blue
+        setCurrentMaterial(0., 1.0, 0., 0., 1., 0., 0., 0., 0., 0.);
+        glVertex3f(0., 0., -0.1);
+        glVertex3f(0., 0., 0.5);
+    glEnd();
 }
 
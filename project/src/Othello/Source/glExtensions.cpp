@@ -0,0 +1,112 @@
+//
+//  glExtensions.cpp
+//  Othello
+//
+
+#include "glExtensions.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(_MSC_VER) || defined(__CYGWIN__) || defined(__MINGW32__)
+    //  Windows: wglGetProcAddress comes with Windows.h
+#elif defined(__APPLE__)
+    #include <dlfcn.h>
+#else
+    #include <GL/glx.h>
+#endif
+
+using namespace graphics3d;
+
+
+namespace {
+    void* getProcAddress(const char* name)
+    {
+#if defined(_MSC_VER) || defined(__CYGWIN__) || defined(__MINGW32__)
+        return (void*) wglGetProcAddress(name);
+#elif defined(__APPLE__)
+        //    the OpenGL framework exports everything the context can do
+        return dlsym(RTLD_DEFAULT, name);
+#else
+        return (void*) glXGetProcAddressARB((const GLubyte*) name);
+#endif
+    }
+
+    template <typename Fn>
+    bool load(Fn& fn, const char* name)
+    {
+        fn = reinterpret_cast<Fn>(getProcAddress(name));
+        return fn != nullptr;
+    }
+
+    GLExtensions loadAll()
+    {
+        GLExtensions ext;
+        std::memset(&ext, 0, sizeof(ext));
+        
+        //    the version string starts with "major.minor"
+        const char* version = (const char*) glGetString(GL_VERSION);
+        int major = 0, minor = 0;
+        if (version != nullptr)
+            sscanf(version, "%d.%d", &major, &minor);
+        
+        bool ok = (major > 1) || (major == 1 && minor >= 5);
+        ok &= load(ext.genBuffers, "glGenBuffers");
+        ok &= load(ext.deleteBuffers, "glDeleteBuffers");
+        ok &= load(ext.bindBuffer, "glBindBuffer");
+        ok &= load(ext.bufferData, "glBufferData");
+        ok &= load(ext.bufferSubData, "glBufferSubData");
+        ext.hasBuffers = ok;
+        
+        //    GLSL 1.20 needs GL 2.0
+        ok = (major >= 2);
+        ok &= load(ext.createShader, "glCreateShader");
+        ok &= load(ext.shaderSource, "glShaderSource");
+        ok &= load(ext.compileShader, "glCompileShader");
+        ok &= load(ext.getShaderiv, "glGetShaderiv");
+        ok &= load(ext.getShaderInfoLog, "glGetShaderInfoLog");
+        ok &= load(ext.deleteShader, "glDeleteShader");
+        ok &= load(ext.createProgram, "glCreateProgram");
+        ok &= load(ext.attachShader, "glAttachShader");
+        ok &= load(ext.bindAttribLocation, "glBindAttribLocation");
+        ok &= load(ext.linkProgram, "glLinkProgram");
+        ok &= load(ext.getProgramiv, "glGetProgramiv");
+        ok &= load(ext.getProgramInfoLog, "glGetProgramInfoLog");
+        ok &= load(ext.useProgram, "glUseProgram");
+        ok &= load(ext.enableVertexAttribArray, "glEnableVertexAttribArray");
+        ok &= load(ext.disableVertexAttribArray, "glDisableVertexAttribArray");
+        ok &= load(ext.vertexAttribPointer, "glVertexAttribPointer");
+        ext.hasShaders = ok;
+        
+        ok = GLExtensions::isSupported("GL_ARB_instanced_arrays");
+        ok &= load(ext.vertexAttribDivisor, "glVertexAttribDivisorARB");
+        ok &= load(ext.drawArraysInstanced, "glDrawArraysInstancedARB");
+        ext.hasInstancing = ok && ext.hasShaders;
+        
+        return ext;
+    }
+}
+
+
+const GLExtensions& GLExtensions::get()
+{
+    static GLExtensions ext = loadAll();
+    return ext;
+}
+
+
+bool GLExtensions::isSupported(const char* extension)
+{
+    const char* all = (const char*) glGetString(GL_EXTENSIONS);
+    if (all == nullptr)
+        return false;
+    //    names are separated by spaces, and one name can be the start of another
+    size_t length = strlen(extension);
+    for (const char* found = strstr(all, extension); found != nullptr; found = strstr(found + length, extension))
+    {
+        bool starts = (found == all) || (found[-1] == ' ');
+        bool ends = (found[length] == ' ') || (found[length] == '\0');
+        if (starts && ends)
+            return true;
+    }
+    return false;
+}
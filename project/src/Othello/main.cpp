@@ -11,6 +11,7 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <cstring>
 #include "drawingUtilities.h"
 #include "common.h"
 #include "Quad3D.h"
@@ -18,6 +19,16 @@
 #include "Cylinder3D.h"
 #include "Board.hpp"
 #include "Disc3D.h"
+#include "Frustum.h"
+#include "ObjectBVH.h"
+#include "LevelOfDetail.h"
+#include "RenderQueue.h"
+#include "BinaryMesh.h"
+#include "MappedFile.h"
+#include "Benchmarks.hpp"
+#include "BatchAnnotator.hpp"
+#include "EngineProtocol.hpp"
+#include "SelfPlayFarm.hpp"
 
 
 using namespace std;
@@ -77,6 +88,15 @@ float Board::drawInPixelScale;
 
 vector<shared_ptr<GraphicObject3D> > objList;
 
+//    objList, split for culling: objects at rest go in the BVH, moving ones are tested one by one
+ObjectBVH staticObjects;
+vector<shared_ptr<GraphicObject3D> > movingObjects;
+vector<GraphicObject3D*> visibleObjects;
+CullStats lastCullStats = {0, 0};
+LodStats lastLodStats = {0, 0};
+RenderQueue renderQueue;
+RenderStateStats lastStateStats = {0, 0, 0, 0, 0};
+
 
 //    Move from the camera to the world reference frame:  Start from the camera and apply
 //    a series of transformations to end up in the world reference frame, where the drawing
@@ -108,8 +128,38 @@ void myDisplayFunc(void)
 //    if (drawReferenceFrames)
     drawReferenceFrame();
     
-    for (auto obj : objList)
-        obj->draw();
+    //    skip what the camera can't see, draw the rest only as finely as it shows,
+    //    sorted so that the GL state changes as little as possible
+    LevelOfDetail::beginFrame();
+    resetRenderStateStats();
+    Frustum frustum = Frustum::fromCurrentMatrices();
+    CullStats cullStats = {0, 0};
+    visibleObjects.clear();
+    staticObjects.cull(frustum, visibleObjects, cullStats);
+    frustum.cull(movingObjects, visibleObjects, cullStats);
+    renderQueue.begin();
+    for (auto obj : visibleObjects)
+        renderQueue.add(*obj);
+    renderQueue.submit();
+    if ((cullStats.drawn != lastCullStats.drawn) || (cullStats.culled != lastCullStats.culled))
+    {
+        cout << "Frame: " << cullStats.drawn << " objects drawn, " << cullStats.culled << " culled" << endl;
+        lastCullStats = cullStats;
+    }
+    const LodStats& lodStats = LevelOfDetail::frameStats();
+    if ((lodStats.trianglesFull != lastLodStats.trianglesFull) || (lodStats.trianglesDrawn != lastLodStats.trianglesDrawn))
+    {
+        cout << "Frame: " << lodStats.trianglesDrawn << " triangles drawn after LOD, of " << lodStats.trianglesFull << endl;
+        lastLodStats = lodStats;
+    }
+    const RenderStateStats& stateStats = renderStateStats();
+    if ((stateStats.materialChanges != lastStateStats.materialChanges) || (stateStats.callsSkipped != lastStateStats.callsSkipped) ||
+        (stateStats.shadeModelChanges != lastStateStats.shadeModelChanges) || (stateStats.lightingChanges != lastStateStats.lightingChanges))
+    {
+        cout << "Frame: " << stateStats.materialChanges << " material, " << stateStats.shadeModelChanges << " shading & "
+             << stateStats.lightingChanges << " lighting changes, " << stateStats.callsSkipped << " state calls skipped" << endl;
+        lastStateStats = stateStats;
+    }
         
     //    back to camera reference frame
     glPopMatrix();
@@ -353,7 +403,7 @@ void myInit(void)
     glLightModelfv(GL_LIGHT_MODEL_LOCAL_VIEWER, local_view);
 
     glFrontFace(GL_CW);
-    glEnable(GL_LIGHTING);
+    setLighting(true);
     glEnable(GL_LIGHT0);
     glEnable(GL_AUTO_NORMAL);
     glEnable(GL_NORMALIZE);
@@ -374,6 +424,16 @@ void myInit(void)
     
     objList.push_back(make_shared<Disc3D>("/Users/michaelfelix/Documents/GitHub/csc406/project/piece.obj", 1.0, 1.0, Pose{-1.f, 0.f, 0.f, 15.f, 0.f, -15.f}));
     objList.back()->setMaterial(gray1);
+    
+    vector<shared_ptr<GraphicObject3D> > restingObjects;
+    for (auto obj : objList)
+    {
+        if (obj->isMoving())
+            movingObjects.push_back(obj);
+        else
+            restingObjects.push_back(obj);
+    }
+    staticObjects.build(restingObjects);
 }
 
 void setupCamera(void)
@@ -392,6 +452,104 @@ void setupCamera(void)
 
 int main(int argc, char** argv)
 {
+    //    --no-optimize-meshes (before anything else): OBJ files are loaded as-is, without MeshOptimizer
+    if ((argc > 1) && (strcmp(argv[1], "--no-optimize-meshes") == 0))
+    {
+        MeshAssetCache::setOptimizeMeshes(false);
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+    
+    //    Command-line modes that run headless (no window is ever created)
+    if ((argc > 1) && (strcmp(argv[1], "--bench-symmetry") == 0))
+        return benchSymmetry(100000, 50);
+    
+    //    --annotate <games file (.wtb or move lists)> <output file> [depth] [threads] [blunder threshold]
+    if ((argc > 3) && (strcmp(argv[1], "--annotate") == 0))
+    {
+        GameDatabase games;
+        if (games.importFile(argv[2]) == 0)
+            return 1;
+        unsigned int depth = (argc > 4) ? atoi(argv[4]) : 2;
+        unsigned int numThreads = (argc > 5) ? atoi(argv[5]) : 0;
+        int blunderThreshold = (argc > 6) ? atoi(argv[6]) : 25;
+        BatchAnnotator annotator(games, depth, numThreads, blunderThreshold);
+        return (annotator.run(argv[3]) > 0) ? 0 : 1;
+    }
+    
+    //    --selfplay <games> <output file> [depth] [worker processes]
+    if ((argc > 3) && (strcmp(argv[1], "--selfplay") == 0))
+    {
+        unsigned int numGames = atoi(argv[2]);
+        unsigned int depth = (argc > 4) ? atoi(argv[4]) : 2;
+        unsigned int numWorkers = (argc > 5) ? atoi(argv[5]) : 0;
+        SelfPlayFarm farm(numWorkers, depth);
+        return (farm.run(numGames, argv[3]) == numGames) ? 0 : 1;
+    }
+    
+    //    --bench-hosting [games] [threads] [nodes per move]
+    if ((argc > 1) && (strcmp(argv[1], "--bench-hosting") == 0))
+    {
+        unsigned int numSessions = (argc > 2) ? atoi(argv[2]) : 1000;
+        unsigned int numThreads = (argc > 3) ? atoi(argv[3]) : 0;
+        unsigned int nodesPerMove = (argc > 4) ? atoi(argv[4]) : 100;
+        return benchHosting(numSessions, numThreads, nodesPerMove);
+    }
+    
+    //    --bench-search [positions] [depth]
+    if ((argc > 1) && (strcmp(argv[1], "--bench-search") == 0))
+    {
+        unsigned int numPositions = (argc > 2) ? atoi(argv[2]) : 200;
+        unsigned int depth = (argc > 3) ? atoi(argv[3]) : 5;
+        return benchSearch(numPositions, depth);
+    }
+    
+    //    --bench-render [cylinders] [rows] [cols] [instances] [frames] [obj file] [expected checksum]
+    if ((argc > 1) && (strcmp(argv[1], "--bench-render") == 0))
+    {
+        unsigned int numCylinders = (argc > 2) ? atoi(argv[2]) : 100;
+        unsigned int numRows = (argc > 3) ? atoi(argv[3]) : 64;
+        unsigned int numCols = (argc > 4) ? atoi(argv[4]) : 64;
+        unsigned int numInstances = (argc > 5) ? atoi(argv[5]) : 64;
+        unsigned int numFrames = (argc > 6) ? atoi(argv[6]) : 100;
+        const char* objPath = (argc > 7) ? argv[7] : "piece.obj";
+        return benchRender(numCylinders, numRows, numCols, numInstances, numFrames, objPath, (argc > 8) ? argv[8] : nullptr);
+    }
+
+    //    --convert-mesh <obj file> [output file]: writes the binary copy that loading the obj file would use
+    //    (by default next to it), e.g. to ship it with the file.
+    if ((argc > 2) && (strcmp(argv[1], "--convert-mesh") == 0))
+    {
+        MappedFile source(argv[2]);
+        if (!source.isOpen())
+        {
+            cout << "Unable to open file " << argv[2] << "\n";
+            return 1;
+        }
+        MeshOptimizerReport report;
+        Mesh mesh = MeshAssetCache::buildObj(source.begin(), source.end(), &report);
+        if (MeshAssetCache::optimizeMeshes())
+            cout << argv[2] << ": " << report.verticesBefore << " -> " << report.verticesAfter << " vertices, "
+                 << report.numTriangles << " triangles, ACMR " << report.acmrBefore << " -> " << report.acmrAfter << "\n";
+        string outputPath = (argc > 3) ? argv[3] : BinaryMesh::cachePathFor(argv[2]);
+        bool written = BinaryMesh::write(outputPath, mesh, BinaryMesh::hashBytes(source.begin(), source.end()), source.size(),
+                                         MeshAssetCache::optimizeMeshes());
+        if (written)
+            cout << outputPath << ": " << mesh.numVertices() << " vertices, " << mesh.parts.size() << " parts\n";
+        return written ? 0 : 1;
+    }
+    
+    //    --engine [cache file]: text protocol on stdin/stdout, for running the AI under a match manager.
+    //    With a cache file, deep results are loaded from it at startup and saved back to it on exit.
+    if ((argc > 1) && (strcmp(argv[1], "--engine") == 0))
+    {
+        EngineProtocol engine(cin, cout);
+        if (argc > 2)
+            engine.useCacheFile(argv[2]);
+        return engine.run();
+    }
+
     //    Initialize glut and create a new window
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);